@@ -42,11 +42,43 @@
 /******************************************************************************/
 #include <stdlib.h>
 #include "adxl362.h"
+#include "util.h"
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+/***************************************************************************//**
+ * @brief Burst read from the FIFO buffer.
+ *
+ * The chip select is kept asserted between the command and the data, so the
+ * data is received straight into buffer.
+ *
+ * @param dev          - The device structure.
+ * @param buffer       - Stores the read bytes.
+ * @param bytes_number - Number of bytes to read.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+static int32_t adxl362_fifo_burst_read(struct adxl362_dev *dev,
+				       uint8_t *buffer,
+				       uint32_t bytes_number)
+{
+	uint8_t command = ADXL362_WRITE_FIFO;
+	struct spi_msg msgs[] = {
+		{
+			.tx_buff = &command,
+			.bytes_number = 1,
+		},
+		{
+			.rx_buff = buffer,
+			.bytes_number = bytes_number,
+		},
+	};
+
+	return spi_transfer(dev->spi_desc, msgs, ARRAY_SIZE(msgs));
+}
+
 /***************************************************************************//**
  * @brief Initializes communication with the device and checks if the part is
  *        present by reading the device id.
@@ -170,20 +202,53 @@ void adxl362_get_fifo_value(struct adxl362_dev *dev,
 			    uint8_t  *buffer,
 			    uint16_t bytes_number)
 {
-	uint8_t spi_buffer[512];
+	adxl362_fifo_burst_read(dev, buffer, bytes_number);
+}
+
+/***************************************************************************//**
+ * @brief Reads the FIFO status for the FIFO streaming engine.
+ *
+ * @param dev     - The device structure.
+ * @param entries - Number of entries in the FIFO.
+ * @param overrun - Set if the FIFO overflowed.
+ *
+ * @return 0 in case of success.
+*******************************************************************************/
+static int32_t adxl362_fifo_get_entries(void *dev,
+					uint16_t *entries,
+					bool *overrun)
+{
+	uint8_t buffer[3] = {0, 0, 0};
 
-	uint16_t index = 0;
+	/* STATUS, FIFO_ENTRIES_L and FIFO_ENTRIES_H are consecutive */
+	adxl362_get_register_value(dev, buffer, ADXL362_REG_STATUS, 3);
+	*overrun = buffer[0] & ADXL362_STATUS_FIFO_OVERRUN;
+	*entries = ((buffer[2] & 0x3) << 8) | buffer[1];
 
-	spi_buffer[0] = ADXL362_WRITE_FIFO;
-	for(index = 0; index < bytes_number; index++)
-		spi_buffer[index + 1] = buffer[index];
-	spi_write_and_read(dev->spi_desc,
-			   spi_buffer,
-			   bytes_number + 1);
-	for(index = 0; index < bytes_number; index++)
-		buffer[index] = spi_buffer[index + 1];
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Burst read from the FIFO for the FIFO streaming engine.
+ *
+ * @param dev          - The device structure.
+ * @param buffer       - Stores the read bytes.
+ * @param bytes_number - Number of bytes to read.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+static int32_t adxl362_fifo_read(void *dev,
+				 uint8_t *buffer,
+				 uint32_t bytes_number)
+{
+	return adxl362_fifo_burst_read(dev, buffer, bytes_number);
 }
 
+const struct adxl_fifo_ops adxl362_fifo_ops = {
+	.get_entries = adxl362_fifo_get_entries,
+	.read = adxl362_fifo_read,
+};
+
 /***************************************************************************//**
  * @brief Resets the device via SPI communication bus.
  *
@@ -45,6 +45,7 @@
 /******************************************************************************/
 #include <stdint.h>
 #include "spi.h"
+#include "adxl_fifo.h"
 
 /******************************************************************************/
 /********************************* ADXL362 ************************************/
@@ -292,4 +293,7 @@ void adxl362_setup_inactivity_detection(struct adxl362_dev *dev,
 					uint16_t threshold,
 					uint16_t time);
 
+/*! FIFO accesses for the FIFO streaming engine, the device is adxl362_dev. */
+extern const struct adxl_fifo_ops adxl362_fifo_ops;
+
 #endif /* __ADXL362_H__ */
@@ -45,6 +45,20 @@
 #include <stdbool.h>
 #include <string.h>
 #include "adxl372.h"
+#include "sample_conv.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* 12 bits samples, left aligned in big endian 16 bits words */
+static const struct scan_type adxl372_scan_type = {
+	.sign = 'u',
+	.realbits = 12,
+	.storagebits = 16,
+	.shift = 4,
+	.is_big_endian = true
+};
 
 /******************************************************************************/
 /************************** Functions Implementation **************************/
@@ -592,7 +606,6 @@ int32_t adxl372_get_fifo_xyz_data(struct adxl372_dev *dev,
 				  uint16_t cnt)
 {
 	uint8_t buf[1024];
-	uint16_t i;
 	int32_t ret;
 
 
@@ -609,16 +622,61 @@ int32_t adxl372_get_fifo_xyz_data(struct adxl372_dev *dev,
 	if (ret < 0)
 		return ret;
 
-	for (i = 0; i < cnt * 2; i += 6) {
-		samples->x = ((buf[i] << 4) | (buf[i+1] >> 4));
-		samples->y = ((buf[i+2] << 4) | (buf[i+3] >> 4));
-		samples->z = ((buf[i+4] << 4) | (buf[i+5] >> 4));
-		samples++;
-	}
+	return sample_conv_unpack16(&adxl372_scan_type, buf,
+				    (int16_t *)samples, cnt);
+}
+
+/**
+ * Get the FIFO status for the FIFO streaming engine.
+ * @param dev - The device structure.
+ * @param entries - Number of entries in the FIFO.
+ * @param overrun - Set if the FIFO overflowed.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t adxl372_fifo_get_entries(void *dev, uint16_t *entries,
+					bool *overrun)
+{
+	uint8_t status1, status2;
+	int32_t ret;
+
+	ret = adxl372_get_status(dev, &status1, &status2, entries);
+	if (ret < 0)
+		return ret;
+
+	*overrun = ADXL372_STATUS_1_FIFO_OVR(status1);
 
 	return ret;
 }
 
+/**
+ * Burst read from the FIFO for the FIFO streaming engine.
+ * @param dev - The device structure.
+ * @param buf - Where to store the FIFO data.
+ * @param bytes - Number of bytes to read.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t adxl372_fifo_read(void *dev, uint8_t *buf, uint32_t bytes)
+{
+	uint32_t chunk;
+	int32_t ret;
+
+	/* Limit of the read without a multi segment SPI transfer */
+	for (; bytes; bytes -= chunk, buf += chunk) {
+		chunk = min(bytes, (uint32_t)ADXL372_MAX_READ_MULTIPLE);
+		ret = adxl372_read_reg_multiple(dev, ADXL372_FIFO_DATA, buf,
+						chunk);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+const struct adxl_fifo_ops adxl372_fifo_ops = {
+	.get_entries = adxl372_fifo_get_entries,
+	.read = adxl372_fifo_read,
+};
+
 /**
  * Retrieve the highest magnitude (x, y, z) sample recorded since the last
  * read of the MAXPEAK registers
@@ -647,11 +705,8 @@ int32_t adxl372_get_highest_peak_data(struct adxl372_dev *dev,
 	if (ret)
 		return ret;
 
-	max_peak->x = (buf[0] << 4) | (buf[1] >> 4);
-	max_peak->y = (buf[2] << 4) | (buf[3] >> 4);
-	max_peak->z = (buf[4] << 4) | (buf[5] >> 4);
-
-	return ret;
+	return sample_conv_unpack16(&adxl372_scan_type, buf,
+				    (int16_t *)max_peak, 3);
 }
 
 /**
@@ -682,11 +737,8 @@ int32_t adxl372_get_accel_data(struct adxl372_dev *dev,
 	if (ret)
 		return ret;
 
-	accel_data->x = (buf[0] << 4) | (buf[1] >> 4);
-	accel_data->y = (buf[2] << 4) | (buf[3] >> 4);
-	accel_data->z = (buf[4] << 4) | (buf[5] >> 4);
-
-	return ret;
+	return sample_conv_unpack16(&adxl372_scan_type, buf,
+				    (int16_t *)accel_data, 3);
 }
 
 /**
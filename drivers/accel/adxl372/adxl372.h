@@ -49,6 +49,7 @@
 #include "gpio.h"
 #include "i2c.h"
 #include "spi.h"
+#include "adxl_fifo.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -121,6 +122,9 @@
 #define ADXL372_REG_READ(x)	(((x & 0xFF) << 1) | 0x01)
 #define ADXL372_REG_WRITE(x)	((x & 0xFF) << 1)
 
+/* Largest multibyte read done through a bounce buffer */
+#define ADXL372_MAX_READ_MULTIPLE	512
+
 /* ADXL372_POWER_CTL */
 #define ADXL372_POWER_CTL_INSTANT_ON_TH_MSK	BIT(5)
 #define ADXL372_POWER_CTL_INSTANT_ON_TH_MODE(x)	(((x) & 0x1) << 5)
@@ -487,4 +491,7 @@ int32_t adxl372_get_accel_data(struct adxl372_dev *dev,
 int32_t adxl372_init(struct adxl372_dev **device,
 		     struct adxl372_init_param init_param);
 
+/* FIFO accesses for the FIFO streaming engine, the device is the adxl372_dev */
+extern const struct adxl_fifo_ops adxl372_fifo_ops;
+
 #endif // ADXL372_H_
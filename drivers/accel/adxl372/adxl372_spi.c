@@ -102,20 +102,19 @@ int32_t adxl372_spi_reg_read_multiple(struct adxl372_dev *dev,
 				      uint8_t *reg_data,
 				      uint16_t count)
 {
-	uint8_t buf[513];
-	int32_t ret;
-
-	if (count > 512)
-		return FAILURE;
+	uint8_t cmd = ADXL372_REG_READ(reg_addr);
+	struct spi_msg msgs[] = {
+		{
+			.tx_buff = &cmd,
+			.bytes_number = 1,
+		},
+		{
+			.rx_buff = reg_data,
+			.bytes_number = count,
+		},
+	};
 
-	buf[0] = ADXL372_REG_READ(reg_addr);
-	memset(&buf[1], 0x00, count);
-
-	ret = spi_write_and_read(dev->spi_desc, buf, count + 1);
-	if (ret < 0)
-		return ret;
-
-	memcpy(reg_data, &buf[1], count);
-
-	return ret;
+	/* The chip select is kept asserted between the command and the data,
+	 * so the data is received straight into reg_data */
+	return spi_transfer(dev->spi_desc, msgs, ARRAY_SIZE(msgs));
 }
@@ -0,0 +1,377 @@
+/***************************************************************************//**
+ *   @file   adxl_fifo.c
+ *   @brief  Implementation of the ADXL FIFO streaming engine
+ *   @author Mihail Chindris (mihail.chindris@analog.com)
+********************************************************************************
+ *   @copyright
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "adxl_fifo.h"
+#include "error.h"
+#include "delay.h"
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Sets dropped with one read when the sample buffer is full */
+#define ADXL_FIFO_DISCARD_SETS	32
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Service the FIFO from the watermark interrupt */
+static void adxl_fifo_irq_handler(void *ctx, uint32_t event, void *extra)
+{
+	if (event) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (extra) {
+		// Unused variable - fix compiler warning
+	}
+
+	adxl_fifo_service(ctx);
+}
+
+/**
+ * @brief Initialize the FIFO streaming engine.
+ *
+ * The device FIFO must already be configured, with its watermark interrupt
+ * mapped to irq_id. A level triggered interrupt is recommended, an edge is
+ * missed if the watermark is crossed while the FIFO is being serviced.
+ * @param fifo - Where to store the engine descriptor.
+ * @param param - Engine parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adxl_fifo_init(struct adxl_fifo **fifo,
+		       const struct adxl_fifo_init_param *param)
+{
+	struct adxl_fifo *desc;
+	uint32_t set_bytes;
+	int32_t ret;
+
+	if (!fifo || !param || !param->ops || !param->ops->get_entries ||
+	    !param->ops->read || !param->entry_bytes || !param->set_entries)
+		return -EINVAL;
+
+	set_bytes = param->entry_bytes * param->set_entries;
+	if (param->buffer_size < set_bytes ||
+	    param->buffer_size % param->entry_bytes)
+		return -EINVAL;
+
+	desc = calloc(1, sizeof(*desc));
+	if (!desc)
+		return -ENOMEM;
+
+	desc->dev = param->dev;
+	desc->ops = param->ops;
+	desc->irq_ctrl = param->irq_ctrl;
+	desc->irq_id = param->irq_id;
+	desc->irq_trig = param->irq_trig;
+	desc->buffer_size = param->buffer_size;
+	desc->entry_bytes = param->entry_bytes;
+	desc->set_entries = param->set_entries;
+	desc->set_bytes = set_bytes;
+	desc->keep_sets = param->keep_sets;
+	desc->timeout_ms = param->timeout_ms ? param->timeout_ms :
+			   ADXL_FIFO_DEFAULT_TIMEOUT_MS;
+
+	desc->discard_size = set_bytes * ADXL_FIFO_DISCARD_SETS;
+	desc->discard = malloc(desc->discard_size);
+	if (!desc->discard) {
+		ret = -ENOMEM;
+		goto error_desc;
+	}
+
+	/* Filled by the interrupt, emptied by the reader */
+	ret = cb_init_spsc(&desc->buffer, param->buffer_size);
+	if (IS_ERR_VALUE(ret))
+		goto error_discard;
+
+	*fifo = desc;
+
+	return SUCCESS;
+
+error_discard:
+	free(desc->discard);
+error_desc:
+	free(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by adxl_fifo_init().
+ * @param fifo - Engine descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adxl_fifo_remove(struct adxl_fifo *fifo)
+{
+	int32_t ret;
+
+	if (!fifo)
+		return -EINVAL;
+
+	if (fifo->started) {
+		ret = adxl_fifo_stop(fifo);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	cb_remove(fifo->buffer);
+	free(fifo->discard);
+	free(fifo);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Empty the FIFO and enable the watermark interrupt.
+ * @param fifo - Engine descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adxl_fifo_start(struct adxl_fifo *fifo)
+{
+	int32_t ret;
+
+	if (!fifo || !fifo->irq_ctrl)
+		return -EINVAL;
+	if (fifo->started)
+		return SUCCESS;
+
+	fifo->irq_cb.callback = adxl_fifo_irq_handler;
+	fifo->irq_cb.ctx = fifo;
+	ret = irq_register_callback(fifo->irq_ctrl, fifo->irq_id,
+				    &fifo->irq_cb);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	ret = irq_trigger_level_set(fifo->irq_ctrl, fifo->irq_id,
+				    fifo->irq_trig);
+	if (IS_ERR_VALUE(ret))
+		goto error_unregister;
+
+	/* Samples already above the watermark would not raise an edge */
+	ret = adxl_fifo_service(fifo);
+	if (IS_ERR_VALUE(ret))
+		goto error_unregister;
+
+	ret = irq_enable(fifo->irq_ctrl, fifo->irq_id);
+	if (IS_ERR_VALUE(ret))
+		goto error_unregister;
+
+	fifo->started = true;
+
+	return SUCCESS;
+
+error_unregister:
+	irq_unregister(fifo->irq_ctrl, fifo->irq_id);
+
+	return ret;
+}
+
+/**
+ * @brief Disable the watermark interrupt.
+ * @param fifo - Engine descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adxl_fifo_stop(struct adxl_fifo *fifo)
+{
+	int32_t ret;
+
+	if (!fifo)
+		return -EINVAL;
+	if (!fifo->started)
+		return SUCCESS;
+
+	ret = irq_disable(fifo->irq_ctrl, fifo->irq_id);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	fifo->started = false;
+
+	return irq_unregister(fifo->irq_ctrl, fifo->irq_id);
+}
+
+/**
+ * @brief Move the FIFO content to the sample buffer.
+ *
+ * Whole sample sets are read with burst reads straight into the sample
+ * buffer. Sets that do not fit are still read out of the device, so that its
+ * FIFO keeps streaming, and counted as dropped.
+ * Called from the watermark interrupt, or by adxl_fifo_read() when there is
+ * no interrupt.
+ * @param fifo - Engine descriptor.
+ * @return Number of sets stored in the sample buffer or negative error code.
+ */
+int32_t adxl_fifo_service(struct adxl_fifo *fifo)
+{
+	uint32_t	sets, stored;
+	uint32_t	bytes, n;
+	uint16_t	entries;
+	uint32_t	used;
+	bool		overrun;
+	void		*buff;
+	int32_t		ret;
+
+	if (!fifo)
+		return -EINVAL;
+
+	ret = fifo->ops->get_entries(fifo->dev, &entries, &overrun);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+	if (overrun)
+		fifo->stats.hw_overruns++;
+
+	sets = entries / fifo->set_entries;
+	if (sets <= fifo->keep_sets)
+		return 0;
+	sets -= fifo->keep_sets;
+
+	ret = cb_size(fifo->buffer, &used);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+	stored = min(sets, (fifo->buffer_size - used) / fifo->set_bytes);
+
+	/* At most two reads, the free space may wrap around */
+	bytes = stored * fifo->set_bytes;
+	while (bytes) {
+		ret = cb_prepare_async_write(fifo->buffer, bytes, &buff, &n);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+
+		ret = fifo->ops->read(fifo->dev, buff, n);
+		if (IS_ERR_VALUE(ret)) {
+			cb_abort_async_write(fifo->buffer);
+			return ret;
+		}
+		cb_end_async_write(fifo->buffer);
+		bytes -= n;
+	}
+	fifo->stats.sets += stored;
+
+	bytes = (sets - stored) * fifo->set_bytes;
+	while (bytes) {
+		n = min(bytes, fifo->discard_size);
+		ret = fifo->ops->read(fifo->dev, fifo->discard, n);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		fifo->stats.dropped_sets += n / fifo->set_bytes;
+		bytes -= n;
+	}
+
+	return stored;
+}
+
+/**
+ * @brief Read samples from the sample buffer.
+ *
+ * Waits until enough samples are available. Without an interrupt the FIFO is
+ * serviced while waiting. With an interrupt, the engine must be started once
+ * the samples already in the buffer are read.
+ * @param fifo - Engine descriptor.
+ * @param buf - Where to store the samples.
+ * @param bytes - Number of bytes to read.
+ * @return SUCCESS in case of success, -ENODEV if the engine is stopped,
+ * -ETIMEDOUT if no new samples arrive for timeout_ms, other negative error
+ * code otherwise.
+ */
+int32_t adxl_fifo_read(struct adxl_fifo *fifo, void *buf, uint32_t bytes)
+{
+	uint8_t		*dst = buf;
+	uint32_t	idle_ms = 0;
+	void		*data;
+	uint32_t	n;
+	int32_t		ret;
+
+	if (!fifo || !buf)
+		return -EINVAL;
+
+	while (bytes) {
+		ret = cb_prepare_async_read(fifo->buffer, bytes, &data, &n);
+		if (ret == -EAGAIN) {
+			if (fifo->irq_ctrl) {
+				if (!fifo->started)
+					return -ENODEV;
+			} else {
+				ret = adxl_fifo_service(fifo);
+				if (IS_ERR_VALUE(ret))
+					return ret;
+				if (ret)
+					continue;
+			}
+			if (idle_ms++ == fifo->timeout_ms)
+				return -ETIMEDOUT;
+			mdelay(1);
+			continue;
+		}
+		if (IS_ERR_VALUE(ret))
+			return ret;
+
+		memcpy(dst, data, n);
+		cb_end_async_read(fifo->buffer);
+		dst += n;
+		bytes -= n;
+		idle_ms = 0;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the streaming counters.
+ * @param fifo - Engine descriptor.
+ * @param stats - Where to store the counters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adxl_fifo_get_stats(struct adxl_fifo *fifo,
+			    struct adxl_fifo_stats *stats)
+{
+	if (!fifo || !stats)
+		return -EINVAL;
+
+	*stats = fifo->stats;
+
+	return SUCCESS;
+}
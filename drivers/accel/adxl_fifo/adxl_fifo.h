@@ -0,0 +1,189 @@
+/***************************************************************************//**
+ *   @file   adxl_fifo.h
+ *   @brief  Header file of the ADXL FIFO streaming engine
+ *   @author Mihail Chindris (mihail.chindris@analog.com)
+********************************************************************************
+ *   @copyright
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef ADXL_FIFO_H
+#define ADXL_FIFO_H
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "irq.h"
+#include "circular_buffer.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Default time adxl_fifo_read() waits for new samples, in milliseconds */
+#define ADXL_FIFO_DEFAULT_TIMEOUT_MS	1000
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct adxl_fifo_ops
+ * @brief Device specific FIFO accesses
+ */
+struct adxl_fifo_ops {
+	/**
+	 * Read the number of entries in the FIFO.
+	 * @param dev - Device handle.
+	 * @param entries - Where to store the number of entries.
+	 * @param overrun - Set if the FIFO overflowed since the last call.
+	 */
+	int32_t (*get_entries)(void *dev, uint16_t *entries, bool *overrun);
+	/**
+	 * Burst read from the FIFO.
+	 * @param dev - Device handle.
+	 * @param buf - Where to store the data.
+	 * @param bytes - Number of bytes, a multiple of the entry size.
+	 */
+	int32_t (*read)(void *dev, uint8_t *buf, uint32_t bytes);
+};
+
+/**
+ * @struct adxl_fifo_stats
+ * @brief Streaming counters, in sample sets
+ */
+struct adxl_fifo_stats {
+	/** Sets stored in the buffer */
+	uint32_t	sets;
+	/** Sets read from the FIFO and dropped because the buffer was full */
+	uint32_t	dropped_sets;
+	/** Number of times the device reported a FIFO overrun */
+	uint32_t	hw_overruns;
+};
+
+/**
+ * @struct adxl_fifo_init_param
+ * @brief Parameters of the FIFO streaming engine
+ */
+struct adxl_fifo_init_param {
+	/** Device handle passed to the ops */
+	void				*dev;
+	/** Device specific FIFO accesses */
+	const struct adxl_fifo_ops	*ops;
+	/** Interrupt controller. If NULL, the FIFO is serviced by
+	 * adxl_fifo_read() */
+	struct irq_ctrl_desc		*irq_ctrl;
+	/** Interrupt of the FIFO watermark */
+	uint32_t			irq_id;
+	/** Trigger level of the FIFO watermark interrupt */
+	enum irq_trig_level		irq_trig;
+	/** Size of a FIFO entry in bytes */
+	uint8_t				entry_bytes;
+	/** Entries of a sample set, for example 3 for x, y and z */
+	uint8_t				set_entries;
+	/** Sets to be left in the FIFO after each read */
+	uint8_t				keep_sets;
+	/** Size of the sample buffer in bytes, must be a power of two */
+	uint32_t			buffer_size;
+	/** Time adxl_fifo_read() waits for new samples, in milliseconds. 0 for
+	 * ADXL_FIFO_DEFAULT_TIMEOUT_MS */
+	uint32_t			timeout_ms;
+};
+
+/**
+ * @struct adxl_fifo
+ * @brief FIFO streaming engine descriptor
+ */
+struct adxl_fifo {
+	/** Device handle passed to the ops */
+	void				*dev;
+	/** Device specific FIFO accesses */
+	const struct adxl_fifo_ops	*ops;
+	/** Interrupt controller */
+	struct irq_ctrl_desc		*irq_ctrl;
+	/** Interrupt of the FIFO watermark */
+	uint32_t			irq_id;
+	/** Trigger level of the FIFO watermark interrupt */
+	enum irq_trig_level		irq_trig;
+	/** Callback registered for the FIFO watermark interrupt */
+	struct callback_desc		irq_cb;
+	/** Sample buffer, written by adxl_fifo_service() */
+	struct circular_buffer		*buffer;
+	/** Size of the sample buffer in bytes */
+	uint32_t			buffer_size;
+	/** Size of a FIFO entry in bytes */
+	uint8_t				entry_bytes;
+	/** Entries of a sample set */
+	uint8_t				set_entries;
+	/** Size of a sample set in bytes */
+	uint32_t			set_bytes;
+	/** Sets to be left in the FIFO after each read */
+	uint8_t				keep_sets;
+	/** Sets dropped are read here */
+	uint8_t				*discard;
+	/** Size of discard in bytes */
+	uint32_t			discard_size;
+	/** Time adxl_fifo_read() waits for new samples, in milliseconds */
+	uint32_t			timeout_ms;
+	/** Streaming counters */
+	struct adxl_fifo_stats		stats;
+	/** Set while the interrupt is enabled */
+	bool				started;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the FIFO streaming engine. */
+int32_t adxl_fifo_init(struct adxl_fifo **fifo,
+		       const struct adxl_fifo_init_param *param);
+/* Free the resources allocated by adxl_fifo_init(). */
+int32_t adxl_fifo_remove(struct adxl_fifo *fifo);
+/* Enable the FIFO watermark interrupt. */
+int32_t adxl_fifo_start(struct adxl_fifo *fifo);
+/* Disable the FIFO watermark interrupt. */
+int32_t adxl_fifo_stop(struct adxl_fifo *fifo);
+/* Move the FIFO content to the sample buffer. */
+int32_t adxl_fifo_service(struct adxl_fifo *fifo);
+/* Read samples from the sample buffer. */
+int32_t adxl_fifo_read(struct adxl_fifo *fifo, void *buf, uint32_t bytes);
+/* Get the streaming counters. */
+int32_t adxl_fifo_get_stats(struct adxl_fifo *fifo,
+			    struct adxl_fifo_stats *stats);
+
+#endif /* ADXL_FIFO_H */
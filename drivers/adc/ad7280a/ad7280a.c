@@ -44,11 +44,40 @@
 /******************************************************************************/
 #include <stdlib.h>
 #include "ad7280a.h"
+#include "crc8.h"
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+DECLARE_CRC8_CONST_TABLE(ad7280a_crc8_table, AD7280A_CRC8_POLY);
 
 /*****************************************************************************/
 /************************ Functions Definitions ******************************/
 /*****************************************************************************/
 
+/******************************************************************************
+ * @brief Computes the CRC of the bits of a codeword that precede the CRC
+ *        field.
+ *
+ * The device CRC is the remainder of the data bits divided by the polynomial,
+ * without the usual multiplication by x^8. This equals the table driven CRC
+ * of all but the last 8 bits, XORed with the last 8 bits.
+ *
+ * @param data : The bits covered by the CRC, right aligned. At most 24 bits
+ *               are used.
+ *
+ * @return The computed CRC.
+******************************************************************************/
+static uint8_t ad7280a_crc8(uint32_t data)
+{
+	uint8_t buf[2];
+
+	buf[0] = (data >> 16) & 0xFF;
+	buf[1] = (data >> 8) & 0xFF;
+
+	return crc8(ad7280a_crc8_table, buf, sizeof(buf), 0) ^ (data & 0xFF);
+}
+
 /******************************************************************************
  * @brief Initializes the communication with the device.
  *
@@ -181,42 +210,11 @@ uint32_t ad7280a_transfer_32bits(struct ad7280a_dev *dev,
 ******************************************************************************/
 uint32_t ad7280a_crc_write(uint32_t message)
 {
-	int32_t i;
 	int32_t crc;
-	int32_t xor1 = 0;
-	int32_t xor2 = 0;
-	int32_t xor3 = 0;
-	int32_t xor4 = 0;
-	int32_t xor5 = 0;
 	uint32_t data_out = 0;
-	int32_t crc0 = 0;
-	int32_t crc1 = 0;
-	int32_t crc2 = 0;
-	int32_t crc3 = 0;
-	int32_t crc4 = 0;
-	int32_t crc5 = 0;
-	int32_t crc6 = 0;
-	int32_t crc7 = 0;
 
 	message = message >> 11;
-	for (i = NUMBITS_WRITE; i >= 0; i--) {
-		xor5 = (crc4 ^ crc7) ? 1 : 0;
-		xor4 = (crc2 ^ crc7) ? 1 : 0;
-		xor3 = (crc1 ^ crc7) ? 1 : 0;
-		xor2 = (crc0 ^ crc7) ? 1 : 0;
-		xor1 = ((message & (1 << i)) ? 1 : 0) ^ (crc7 ? 1 : 0);
-		crc7 = crc6;
-		crc6 = crc5;
-		crc5 = xor5;
-		crc4 = crc3;
-		crc3 = xor4;
-		crc2 = xor3;
-		crc1 = xor2;
-		crc0 = xor1;
-	}
-	crc = (crc0 ? (1 << 0) : 0) | (crc1 ? (1 << 1) : 0) | (crc2 ? (1 << 2) : 0) |
-	      (crc3 ? (1 << 3) : 0) | (crc4 ? (1 << 4) : 0) | (crc5 ? (1 << 5) : 0) |
-	      (crc6 ? (1 << 6) : 0) | (crc7 ? (1 << 7) : 0);
+	crc = ad7280a_crc8(message & ((1ul << (NUMBITS_WRITE + 1)) - 1));
 	data_out = (message << 11) | (crc << 3) | 2;
 
 	return data_out;
@@ -233,45 +231,13 @@ uint32_t ad7280a_crc_write(uint32_t message)
 ******************************************************************************/
 int32_t ad7280a_crc_read(uint32_t message)
 {
-	int32_t i;
 	uint32_t data_in = 0;
 	int32_t crc_rec;
 	int32_t crc_computed;
-	int32_t xor1 = 0;
-	int32_t xor2 = 0;
-	int32_t xor3 = 0;
-	int32_t xor4 = 0;
-	int32_t xor5 = 0;
-	int32_t crc0 = 0;
-	int32_t crc1 = 0;
-	int32_t crc2 = 0;
-	int32_t crc3 = 0;
-	int32_t crc4 = 0;
-	int32_t crc5 = 0;
-	int32_t crc6 = 0;
-	int32_t crc7 = 0;
 
 	crc_rec= (message >> 2) & 0xFF;
 	data_in = message >> 10;
-	for (i = NUMBITS_READ; i >= 0; i--) {
-		xor5 = (crc4 ^ crc7) ? 1 : 0;
-		xor4 = (crc2 ^ crc7) ? 1 : 0;
-		xor3 = (crc1 ^ crc7) ? 1 : 0;
-		xor2 = (crc0 ^ crc7) ? 1 : 0;
-		xor1 = ((data_in & (1 << i)) ? 1 : 0) ^ (crc7 ? 1 : 0);
-		crc7 = crc6;
-		crc6 = crc5;
-		crc5 = xor5;
-		crc4 = crc3;
-		crc3 = xor4;
-		crc2 = xor3;
-		crc1 = xor2;
-		crc0 = xor1;
-	}
-	crc_computed = (crc0 ? (1 << 0) : 0) | (crc1 ? (1 << 1) : 0) |
-		       (crc2 ? (1 << 2) : 0) | (crc3 ? (1 << 3) : 0) |
-		       (crc4 ? (1 << 4) : 0) | (crc5 ? (1 << 5) : 0) |
-		       (crc6 ? (1 << 6) : 0) | (crc7 ? (1 << 7) : 0);
+	crc_computed = ad7280a_crc8(data_in & ((1ul << (NUMBITS_READ + 1)) - 1));
 	if (crc_rec == crc_computed) {
 		return 1;
 	} else {
@@ -164,6 +164,7 @@
 
 #define NUMBITS_READ        22   // Number of bits for CRC when reading
 #define NUMBITS_WRITE       21   // Number of bits for CRC when writing
+#define AD7280A_CRC8_POLY   0x2F // x^8 + x^5 + x^3 + x^2 + x^1 + x^0
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
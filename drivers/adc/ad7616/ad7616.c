@@ -437,7 +437,7 @@ int32_t ad7616_read_data_parallel(struct ad7616_dev *dev,
 {
 	int32_t ret;
 	struct axi_dmac			*dmac;
-	struct axi_dmac_init	dmac_init;
+	struct axi_dmac_init	dmac_init = {0};
 
 	dmac_init.name = "ADC DMAC";
 	dmac_init.base = dev->offload_init_param->rx_dma_baseaddr;
@@ -47,6 +47,13 @@
 #include "ad77681.h"
 #include "error.h"
 #include "delay.h"
+#include "sample_conv.h"
+#include "crc8.h"
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+DECLARE_CRC8_SLICE_TABLE(ad77681_crc8_table, AD77681_CRC8_POLY);
 
 /******************************************************************************/
 /************************** Functions Implementation **************************/
@@ -62,21 +69,7 @@ uint8_t ad77681_compute_crc8(uint8_t *data,
 			     uint8_t data_size,
 			     uint8_t init_val)
 {
-	uint8_t i;
-	uint8_t crc = init_val;
-
-	while (data_size) {
-		for (i = 0x80; i != 0; i >>= 1) {
-			if (((crc & 0x80) != 0) != ((*data & i) != 0)) {
-				crc <<= 1;
-				crc ^= AD77681_CRC8_POLY;
-			} else
-				crc <<= 1;
-		}
-		data++;
-		data_size--;
-	}
-	return crc;
+	return crc8_slice(ad77681_crc8_table, data, data_size, init_val);
 }
 
 /**
@@ -406,10 +399,7 @@ int32_t ad77681_data_to_voltage(struct ad77681_dev *dev,
 {
 	int32_t converted_data;
 
-	if (*raw_code & 0x800000)
-		converted_data = (int32_t)((0xFF << 24) | *raw_code);
-	else
-		converted_data = (int32_t)((0x00 << 24) | *raw_code);
+	converted_data = sample_conv_sign_extend(*raw_code, AD7768_N_BITS);
 
 	/* ((2*Vref)*code)/2^24	*/
 	*voltage = (double)(((2.0 * (((double)(dev->vref)) / 1000.0)) /
@@ -47,56 +47,100 @@
 #include "axi_io.h"
 #include "error.h"
 #include "delay.h"
+#include "timer.h"
 #include "axi_dmac.h"
 
+/***************************************************************************//**
+ * @brief Program a descriptor in the core and start it.
+*******************************************************************************/
+static void axi_dmac_start_desc(struct axi_dmac *dmac,
+				struct axi_dmac_desc *desc)
+{
+	uint32_t y_length;
+
+	y_length = desc->y_length ? desc->y_length - 1 : 0;
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &desc->transfer_id);
+	if (dmac->direction == DMA_DEV_TO_MEM) {
+		axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS, desc->address);
+		axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE, desc->stride);
+	} else {
+		axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS, desc->address);
+		axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, desc->stride);
+	}
+	axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, desc->x_length - 1);
+	axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, y_length);
+	axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, desc->flags);
+	axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
+}
+
+/***************************************************************************//**
+ * @brief Retire the completed descriptors and move the queued ones to the
+ * hardware while it has room for them. Must be called with the interrupts of
+ * the core masked or from the ISR.
+*******************************************************************************/
+static void axi_dmac_queue_advance(struct axi_dmac *dmac)
+{
+	struct axi_dmac_desc *desc;
+	uint32_t reg_val;
+
+	dmac->in_advance = true;
+
+	/* The core completes the transfers in the order they were queued. */
+	if (dmac->active_head) {
+		axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_DONE, &reg_val);
+		while (dmac->active_head &&
+		       (reg_val & BIT(dmac->active_head->transfer_id))) {
+			desc = dmac->active_head;
+			dmac->active_head = desc->next;
+			if (!dmac->active_head)
+				dmac->active_tail = NULL;
+			desc->next = NULL;
+			desc->done = true;
+			/* May submit new descriptors, they are only queued. */
+			if (desc->callback)
+				desc->callback(desc->ctx, desc);
+		}
+	}
+
+	while (dmac->queue_head) {
+		axi_dmac_read(dmac, AXI_DMAC_REG_START_TRANSFER, &reg_val);
+		if (reg_val & 1)
+			break; /* The hardware queue is full. */
+
+		desc = dmac->queue_head;
+		dmac->queue_head = desc->next;
+		if (!dmac->queue_head)
+			dmac->queue_tail = NULL;
+		desc->next = NULL;
+
+		axi_dmac_start_desc(dmac, desc);
+
+		if (dmac->active_tail)
+			dmac->active_tail->next = desc;
+		else
+			dmac->active_head = desc;
+		dmac->active_tail = desc;
+	}
+
+	dmac->in_advance = false;
+}
+
 /***************************************************************************//**
  * @brief dma_isr
 *******************************************************************************/
 void axi_dmac_default_isr(void *instance)
 {
 	struct axi_dmac *dmac = (struct axi_dmac *)instance;
-	uint32_t remaining_size, burst_size;
 	uint32_t reg_val;
 
 	/* Get interrupt sources and clear interrupts. */
 	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
 	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
 
-	if ((reg_val & AXI_DMAC_IRQ_SOT) && (dmac->big_transfer.size != 0)) {
-		remaining_size = dmac->big_transfer.size -
-				 dmac->big_transfer.size_done;
-		burst_size = (remaining_size <= dmac->transfer_max_size) ?
-			     remaining_size : dmac->transfer_max_size;
-
-		dmac->big_transfer.size_done += burst_size;
-		dmac->big_transfer.address += burst_size;
-		switch (dmac->direction) {
-		case DMA_DEV_TO_MEM:
-			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS,
-				       dmac->big_transfer.address);
-			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE, 0x0);
-			break;
-		case DMA_MEM_TO_DEV:
-			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS,
-				       dmac->big_transfer.address);
-			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, 0x0);
-			break;
-		default:
-			return; // Other directions are not supported yet
-		}
-		/* The current transfer was started and a new one is queued. */
-		axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH,
-			       burst_size);
-		axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
-
-		axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
-	}
-	if (reg_val & AXI_DMAC_IRQ_EOT) {
-		dmac->big_transfer.transfer_done = true;
-		dmac->big_transfer.address = 0;
-		dmac->big_transfer.size = 0;
-		dmac->big_transfer.size_done = 0;
-	}
+	/* SOT: there is room in the hardware queue, EOT: a transfer is done. */
+	if (dmac->queue_head || dmac->active_head)
+		axi_dmac_queue_advance(dmac);
 }
 
 /***************************************************************************//**
@@ -125,167 +169,376 @@ int32_t axi_dmac_write(struct axi_dmac *dmac,
 
 /***************************************************************************//**
  * @brief axi_dmac_transfer_nonblock
+ * Start a transfer. Use axi_dmac_is_transfer_ready() to check if it is done.
  *******************************************************************************/
 int32_t axi_dmac_transfer_nonblocking(struct axi_dmac *dmac,
 				      uint32_t address, uint32_t size)
+{
+	return axi_dmac_transfer_start(dmac, address, size, NULL, NULL);
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_is_transfer_ready
+ * Check if all the transfers started with axi_dmac_transfer_start() or
+ * axi_dmac_submit() are done.
+ *******************************************************************************/
+int32_t axi_dmac_is_transfer_ready(struct axi_dmac *dmac, bool *rdy)
+{
+	if (!dmac || !rdy)
+		return FAILURE;
+
+	*rdy = !dmac->big_transfer.size && !dmac->queue_head &&
+	       !dmac->active_head;
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief Add a descriptor to the submission queue. Also used for the chunks of
+ * the transfer started with axi_dmac_transfer_start().
+ *******************************************************************************/
+static int32_t __axi_dmac_submit(struct axi_dmac *dmac,
+				 struct axi_dmac_desc *desc)
 {
 	uint32_t reg_val;
 
-	if (size == 0)
-		return SUCCESS; /* nothing to do */
+	if (!desc->x_length || desc->x_length - 1 > dmac->transfer_max_size)
+		return -EINVAL;
+
+	desc->done = false;
+	desc->next = NULL;
+
+	/* Called from a completion callback, the queue is advanced after it. */
+	if (dmac->in_advance) {
+		if (dmac->queue_tail)
+			dmac->queue_tail->next = desc;
+		else
+			dmac->queue_head = desc;
+		dmac->queue_tail = desc;
+
+		return SUCCESS;
+	}
+
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK,
+		       AXI_DMAC_IRQ_SOT | AXI_DMAC_IRQ_EOT);
 
 	axi_dmac_read(dmac, AXI_DMAC_REG_CTRL, &reg_val);
 	if (!(reg_val & AXI_DMAC_CTRL_ENABLE)) {
 		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
 		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
-		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
 	}
 
-	axi_dmac_read(dmac, AXI_DMAC_REG_START_TRANSFER, &reg_val);
-	if (!(reg_val & 1)) {
-		switch (dmac->direction) {
-		case DMA_DEV_TO_MEM:
-			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS, address);
-			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE, 0x0);
-			break;
-		case DMA_MEM_TO_DEV:
-			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS, address);
-			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, 0x0);
-			break;
-		default:
-			return FAILURE; // Other directions are not supported yet
-		}
-		if ((size - 1) > dmac->transfer_max_size) {
-			dmac->big_transfer.address = address;
-			dmac->big_transfer.size = size - 1;
-			dmac->big_transfer.size_done = dmac->transfer_max_size;
+	if (dmac->queue_tail)
+		dmac->queue_tail->next = desc;
+	else
+		dmac->queue_head = desc;
+	dmac->queue_tail = desc;
 
-			axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH,
-				       dmac->transfer_max_size);
-			axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+	axi_dmac_queue_advance(dmac);
 
-			axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, dmac->flags);
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
 
-			axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
-		} else {
-			axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH,
-				       size - 1);
-			axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+	return SUCCESS;
+}
 
-			axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, dmac->flags);
+/***************************************************************************//**
+ * @brief axi_dmac_submit
+ * Add a transfer descriptor to the submission queue. It is started as soon as
+ * the hardware has room for it and axi_dmac_default_isr() starts the next
+ * ones and calls the completion callbacks. Without an interrupt connected,
+ * call axi_dmac_queue_process() to advance the queue.
+ * Returns -EBUSY while a transfer started with axi_dmac_transfer_start() is
+ * in progress.
+ *******************************************************************************/
+int32_t axi_dmac_submit(struct axi_dmac *dmac, struct axi_dmac_desc *desc)
+{
+	if (!dmac || !desc)
+		return -EINVAL;
 
-			axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
-		}
-	} else {
-		return FAILURE;
-	}
+	if (dmac->big_transfer.size)
+		return -EBUSY;
 
-	return SUCCESS;
+	return __axi_dmac_submit(dmac, desc);
 }
 
 /***************************************************************************//**
- * @brief axi_dmac_is_transfer_ready
+ * @brief axi_dmac_queue_process
+ * Advance the submission queue from outside the ISR.
  *******************************************************************************/
-int32_t axi_dmac_is_transfer_ready(struct axi_dmac *dmac, bool *rdy)
+void axi_dmac_queue_process(struct axi_dmac *dmac)
 {
-	*rdy = dmac->big_transfer.transfer_done;
+	if (dmac->in_advance)
+		return;
 
-	return SUCCESS;
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK,
+		       AXI_DMAC_IRQ_SOT | AXI_DMAC_IRQ_EOT);
+	axi_dmac_queue_advance(dmac);
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
 }
 
 /***************************************************************************//**
- * @brief axi_dmac_transfer
+ * @brief axi_dmac_abort
+ * Stop the core and drop all the submitted descriptors. The callbacks of the
+ * dropped descriptors are not called.
  *******************************************************************************/
-int32_t axi_dmac_transfer(struct axi_dmac *dmac,
-			  uint32_t address, uint32_t size)
+void axi_dmac_abort(struct axi_dmac *dmac)
 {
-	uint32_t transfer_id;
-	uint32_t reg_val;
-	uint32_t timeout = 0;
-
-	if (size == 0)
-		return SUCCESS; /* nothing to do */
+	struct axi_dmac_desc *desc;
 
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK,
+		       AXI_DMAC_IRQ_SOT | AXI_DMAC_IRQ_EOT);
 	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
-	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
 
-	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
+	while (dmac->active_head) {
+		desc = dmac->active_head;
+		dmac->active_head = desc->next;
+		desc->next = NULL;
+	}
+	while (dmac->queue_head) {
+		desc = dmac->queue_head;
+		dmac->queue_head = desc->next;
+		desc->next = NULL;
+	}
+	dmac->active_tail = NULL;
+	dmac->queue_tail = NULL;
+	dmac->big_transfer.size = 0;
+	dmac->big_transfer.cyclic = false;
 
-	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &transfer_id);
-	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
-	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
+}
 
-	switch (dmac->direction) {
-	case DMA_DEV_TO_MEM:
-		axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS, address);
-		axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE, 0x0);
-		break;
-	case DMA_MEM_TO_DEV:
-		axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS, address);
-		axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, 0x0);
-		break;
-	default:
-		return FAILURE; // Other directions are not supported yet
+/***************************************************************************//**
+ * @brief Submit the next chunk of the current transfer using desc.
+ *******************************************************************************/
+static int32_t axi_dmac_transfer_submit_chunk(struct axi_dmac *dmac,
+		struct axi_dmac_desc *desc)
+{
+	struct axi_dma_transfer *xfer = &dmac->big_transfer;
+	int32_t ret;
+
+	desc->address = xfer->address + xfer->size_queued;
+	desc->x_length = xfer->size - xfer->size_queued;
+	if (desc->x_length - 1 > dmac->transfer_max_size)
+		desc->x_length = dmac->transfer_max_size + 1;
+	desc->y_length = 0;
+	desc->stride = 0;
+	desc->flags = dmac->flags;
+
+	/* Account for the chunk first, the submission may complete the other
+	 * chunk and resubmit it from its callback. */
+	xfer->size_queued += desc->x_length;
+	ret = __axi_dmac_submit(dmac, desc);
+	if (IS_ERR_VALUE(ret)) {
+		xfer->size_queued -= desc->x_length;
+		return ret;
 	}
 
-	if ((size - 1) > dmac->transfer_max_size) {
-		dmac->big_transfer.address = address;
-		dmac->big_transfer.size = size - 1;
-		dmac->big_transfer.size_done = dmac->transfer_max_size;
+	return SUCCESS;
+}
 
-		axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH,
-			       dmac->transfer_max_size);
-		axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+/***************************************************************************//**
+ * @brief Completion callback of a chunk. Reuses the descriptor for the next
+ * chunk or completes the transfer.
+ *******************************************************************************/
+static void axi_dmac_transfer_chunk_done(void *ctx, struct axi_dmac_desc *desc)
+{
+	struct axi_dmac *dmac = (struct axi_dmac *)ctx;
+	struct axi_dma_transfer *xfer = &dmac->big_transfer;
 
-		axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, dmac->flags);
+	xfer->size_done += desc->x_length;
+	if (xfer->size_queued < xfer->size) {
+		axi_dmac_transfer_submit_chunk(dmac, desc);
+		return;
+	}
+	if (xfer->size_done < xfer->size)
+		return; /* The other chunk is still in progress. */
 
-		axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
+	xfer->size = 0;
+	xfer->transfer_done = true;
+	if (xfer->callback)
+		xfer->callback(xfer->ctx);
+}
 
-		while(!dmac->big_transfer.transfer_done) {
-			timeout++;
-			if (timeout == UINT32_MAX)
-				return FAILURE;
-		}
+/***************************************************************************//**
+ * @brief Elapsed timer ticks since the last call. Works with up and down
+ * counters, as long as it is called more often than half the timer period.
+ *******************************************************************************/
+static uint32_t axi_dmac_elapsed_ticks(struct axi_dmac *dmac, uint32_t *last)
+{
+	uint64_t period;
+	uint64_t forward;
+	uint32_t counter;
 
-		dmac->big_transfer.address = 0;
-		dmac->big_transfer.size = 0;
-		dmac->big_transfer.size_done = 0;
+	if (dmac->timer_counter_get(dmac->timer, &counter))
+		return 0;
 
-		return SUCCESS;
-	}
+	period = dmac->timer->load_value ?
+		 (uint64_t)dmac->timer->load_value + 1 : 0x100000000ull;
+	forward = ((uint64_t)counter + period - *last) % period;
+	*last = counter;
 
-	axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, size - 1);
-	axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+	return min(forward, period - forward);
+}
 
-	axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, dmac->flags);
+/***************************************************************************//**
+ * @brief axi_dmac_transfer_start
+ * Start a transfer of any size. It is advanced by axi_dmac_default_isr(),
+ * which calls callback when the transfer is done. callback may be NULL.
+ * Transfers with the DMA_CYCLIC flag never complete.
+ *******************************************************************************/
+int32_t axi_dmac_transfer_start(struct axi_dmac *dmac,
+				uint32_t address, uint32_t size,
+				void (*callback)(void *ctx), void *ctx)
+{
+	struct axi_dma_transfer *xfer;
+	uint32_t reg_val;
+	int32_t ret;
 
-	axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
+	if (!dmac)
+		return -EINVAL;
 
-	if (dmac->flags & DMA_CYCLIC)
-		return SUCCESS;
+	xfer = &dmac->big_transfer;
+	/* A new transfer replaces a cyclic one, as it never completes. */
+	if (xfer->size && xfer->cyclic)
+		axi_dmac_abort(dmac);
+	if (xfer->size)
+		return -EBUSY;
 
-	/* Wait until the new transfer is queued. */
-	do {
-		axi_dmac_read(dmac, AXI_DMAC_REG_START_TRANSFER, &reg_val);
-	} while(reg_val == 1);
+	if (size == 0) {
+		xfer->transfer_done = true;
+		return SUCCESS; /* nothing to do */
+	}
+
+	if ((dmac->flags & DMA_CYCLIC) && size - 1 > dmac->transfer_max_size)
+		return -EINVAL;
 
-	/* Wait until the current transfer is completed. */
-	do {
+	/* Start from a clean state if nothing else uses the core. */
+	if (!dmac->queue_head && !dmac->active_head) {
+		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
+		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
 		axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
-		if (reg_val == (AXI_DMAC_IRQ_SOT | AXI_DMAC_IRQ_EOT))
-			break;
-	} while(!dmac->big_transfer.transfer_done);
-	if (reg_val != (AXI_DMAC_IRQ_SOT | AXI_DMAC_IRQ_EOT))
 		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
+	}
 
-	/* Wait until the transfer with the ID transfer_id is completed. */
-	do {
-		axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_DONE, &reg_val);
-	} while((reg_val & (1u << transfer_id)) != (1u << transfer_id));
+	xfer->address = address;
+	xfer->size = size;
+	xfer->size_done = 0;
+	xfer->size_queued = 0;
+	xfer->transfer_done = false;
+	xfer->cyclic = dmac->flags & DMA_CYCLIC;
+	xfer->callback = callback;
+	xfer->ctx = ctx;
+	xfer->chunks[0].callback = axi_dmac_transfer_chunk_done;
+	xfer->chunks[0].ctx = dmac;
+	xfer->chunks[1].callback = axi_dmac_transfer_chunk_done;
+	xfer->chunks[1].ctx = dmac;
+
+	ret = axi_dmac_transfer_submit_chunk(dmac, &xfer->chunks[0]);
+	if (IS_ERR_VALUE(ret)) {
+		xfer->size = 0;
+		return ret;
+	}
+	if (xfer->size_queued < xfer->size) {
+		ret = axi_dmac_transfer_submit_chunk(dmac, &xfer->chunks[1]);
+		if (IS_ERR_VALUE(ret)) {
+			axi_dmac_abort(dmac);
+			return ret;
+		}
+	}
 
 	return SUCCESS;
 }
 
+/***************************************************************************//**
+ * @brief Advance the queue until done is set. The queue is aborted on timeout.
+ * Without a timer, timeout_ms is ignored and the wait is bounded by a number
+ * of polls.
+ *******************************************************************************/
+static int32_t axi_dmac_wait(struct axi_dmac *dmac, volatile bool *done,
+			     uint32_t timeout_ms)
+{
+	uint64_t timeout_ticks;
+	uint64_t ticks;
+	uint32_t counter;
+	uint32_t polls;
+
+	timeout_ticks = 0;
+	if (dmac->timer) {
+		timeout_ticks = (uint64_t)dmac->timer->freq_hz * timeout_ms / 1000;
+		if (dmac->timer_counter_get(dmac->timer, &counter))
+			return FAILURE;
+	}
+
+	ticks = 0;
+	polls = 0;
+	while (!*done) {
+		/* Advances the queue if no interrupt is connected. */
+		axi_dmac_queue_process(dmac);
+		if (dmac->timer) {
+			ticks += axi_dmac_elapsed_ticks(dmac, &counter);
+			if (ticks > timeout_ticks)
+				goto timeout;
+		} else if (++polls == UINT32_MAX) {
+			goto timeout;
+		}
+	}
+
+	return SUCCESS;
+timeout:
+	axi_dmac_abort(dmac);
+
+	return -ETIMEDOUT;
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_transfer_wait_completion
+ * Wait until the transfer started with axi_dmac_transfer_start() is done.
+ * The transfer is aborted on timeout. Without a timer, timeout_ms is ignored
+ * and the wait is bounded by a number of polls.
+ *******************************************************************************/
+int32_t axi_dmac_transfer_wait_completion(struct axi_dmac *dmac,
+		uint32_t timeout_ms)
+{
+	if (!dmac)
+		return -EINVAL;
+
+	return axi_dmac_wait(dmac, &dmac->big_transfer.transfer_done,
+			     timeout_ms);
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_desc_wait
+ * Wait until a descriptor added with axi_dmac_submit() is done, with the
+ * timeout of axi_dmac_transfer(). All the submitted descriptors are dropped
+ * on timeout.
+ *******************************************************************************/
+int32_t axi_dmac_desc_wait(struct axi_dmac *dmac, struct axi_dmac_desc *desc)
+{
+	if (!dmac || !desc)
+		return -EINVAL;
+
+	return axi_dmac_wait(dmac, &desc->done, dmac->timeout_ms);
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_transfer
+ * Blocking transfer. Transfers with the DMA_CYCLIC flag return once started.
+ *******************************************************************************/
+int32_t axi_dmac_transfer(struct axi_dmac *dmac,
+			  uint32_t address, uint32_t size)
+{
+	int32_t ret;
+
+	ret = axi_dmac_transfer_start(dmac, address, size, NULL, NULL);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	if (dmac->flags & DMA_CYCLIC)
+		return SUCCESS;
+
+	return axi_dmac_transfer_wait_completion(dmac, dmac->timeout_ms);
+}
+
 /***************************************************************************//**
  * @brief axi_dmac_init
  *******************************************************************************/
@@ -294,7 +547,7 @@ int32_t axi_dmac_init(struct axi_dmac **dmac_core,
 {
 	struct axi_dmac *dmac;
 
-	dmac = (struct axi_dmac *)malloc(sizeof(*dmac));
+	dmac = (struct axi_dmac *)calloc(1, sizeof(*dmac));
 	if (!dmac)
 		return FAILURE;
 
@@ -303,9 +556,12 @@ int32_t axi_dmac_init(struct axi_dmac **dmac_core,
 	dmac->direction = init->direction;
 	dmac->flags = init->flags;
 	dmac->transfer_max_size = -1;
-	dmac->big_transfer.address = 0;
-	dmac->big_transfer.size = 0;
-	dmac->big_transfer.size_done = 0;
+	dmac->timer = init->timer;
+	dmac->timer_counter_get = init->timer_counter_get;
+	if (!dmac->timer_counter_get)
+		dmac->timer = NULL;
+	dmac->timeout_ms = init->timeout_ms ? init->timeout_ms :
+			   AXI_DMAC_DEFAULT_TIMEOUT_MS;
 
 	axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, dmac->transfer_max_size);
 	axi_dmac_read(dmac, AXI_DMAC_REG_X_LENGTH, &dmac->transfer_max_size);
@@ -68,6 +68,8 @@
 #define AXI_DMAC_REG_SRC_STRIDE		0x424
 #define AXI_DMAC_REG_TRANSFER_DONE	0x428
 
+#define AXI_DMAC_DEFAULT_TIMEOUT_MS	1000
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -81,20 +83,85 @@ enum dma_flags {
 	DMA_LAST = 2
 };
 
+/**
+ * @struct axi_dmac_desc
+ * @brief Transfer descriptor for the submission queue. It is owned by the
+ * caller and must stay valid until the transfer is done.
+ */
+struct axi_dmac_desc {
+	/** Address of the first byte of the transfer */
+	uint32_t address;
+	/** Number of bytes of a row */
+	uint32_t x_length;
+	/** Number of rows. 0 or 1 for a one dimensional transfer. Two
+	 * dimensional transfers need a core built with DMA_2D_TRANSFER */
+	uint32_t y_length;
+	/** Distance in bytes between the starts of two consecutive rows */
+	uint32_t stride;
+	/** Transfer flags written to AXI_DMAC_REG_FLAGS (Ex: DMA_LAST) */
+	uint32_t flags;
+	/** Called from axi_dmac_default_isr() when the transfer is done */
+	void (*callback)(void *ctx, struct axi_dmac_desc *desc);
+	/** Parameter passed to callback */
+	void *ctx;
+	/** Set when the transfer is done */
+	volatile bool done;
+	/** Private. ID assigned by the core */
+	uint32_t transfer_id;
+	/** Private. Next descriptor in the queue */
+	struct axi_dmac_desc *next;
+};
+
+/**
+ * @struct axi_dma_transfer
+ * @brief Transfer started by axi_dmac_transfer_start(). Transfers bigger
+ * than what the core supports are split in chunks, and two chunks are kept
+ * in the hardware queue so there is no gap between them.
+ */
 struct axi_dma_transfer {
+	/** Size of the transfer. 0 if no transfer is in progress */
 	uint32_t size;
+	/** Address of the transfer */
 	uint32_t address;
+	/** Number of bytes already transferred */
 	uint32_t size_done;
+	/** Number of bytes already submitted to the queue */
+	uint32_t size_queued;
+	/** Set when the transfer is done */
 	volatile bool transfer_done;
+	/** Set for DMA_CYCLIC transfers, which never complete */
+	bool cyclic;
+	/** Called from axi_dmac_default_isr() when the transfer is done */
+	void (*callback)(void *ctx);
+	/** Parameter passed to callback */
+	void *ctx;
+	/** Descriptors of the chunks */
+	struct axi_dmac_desc chunks[2];
 };
 
+struct timer_desc;
+
 struct axi_dmac {
 	const char *name;
 	uint32_t base;
 	enum dma_direction direction;
 	uint32_t flags;
 	uint32_t transfer_max_size;
-	volatile struct axi_dma_transfer big_transfer;
+	struct axi_dma_transfer big_transfer;
+	/** Submitted descriptors waiting for room in the hardware queue */
+	struct axi_dmac_desc *queue_head;
+	struct axi_dmac_desc *queue_tail;
+	/** Descriptors given to the hardware, in the order of completion */
+	struct axi_dmac_desc *active_head;
+	struct axi_dmac_desc *active_tail;
+	/** Set while the queue is advanced */
+	bool in_advance;
+	/** Timer used for the timeout of axi_dmac_transfer() */
+	struct timer_desc *timer;
+	/** Counter getter of the timer */
+	int32_t (*timer_counter_get)(struct timer_desc *desc, uint32_t *counter);
+	/** Timeout of axi_dmac_transfer() in milliseconds */
+	uint32_t timeout_ms;
 };
 
 struct axi_dmac_init {
@@ -102,6 +169,14 @@ struct axi_dmac_init {
 	uint32_t base;
 	enum dma_direction direction;
 	uint32_t flags;
+	/** Optional started timer, used for the timeout of axi_dmac_transfer().
+	 * Without it, the wait is only bounded by a number of polls */
+	struct timer_desc *timer;
+	/** Set to timer_counter_get when a timer is used */
+	int32_t (*timer_counter_get)(struct timer_desc *desc, uint32_t *counter);
+	/** Timeout of axi_dmac_transfer() in milliseconds. 0 for the default
+	 * AXI_DMAC_DEFAULT_TIMEOUT_MS */
+	uint32_t timeout_ms;
 };
 
 /******************************************************************************/
@@ -112,9 +187,18 @@ int32_t axi_dmac_read(struct axi_dmac *dmac, uint32_t reg_addr,
 		      uint32_t *reg_data);
 int32_t axi_dmac_write(struct axi_dmac *dmac, uint32_t reg_addr,
 		       uint32_t reg_data);
+int32_t axi_dmac_transfer_start(struct axi_dmac *dmac,
+				uint32_t address, uint32_t size,
+				void (*callback)(void *ctx), void *ctx);
+int32_t axi_dmac_transfer_wait_completion(struct axi_dmac *dmac,
+		uint32_t timeout_ms);
 int32_t axi_dmac_transfer_nonblocking(struct axi_dmac *dmac,
 				      uint32_t address, uint32_t size);
 int32_t axi_dmac_is_transfer_ready(struct axi_dmac *dmac, bool *rdy);
+int32_t axi_dmac_submit(struct axi_dmac *dmac, struct axi_dmac_desc *desc);
+int32_t axi_dmac_desc_wait(struct axi_dmac *dmac, struct axi_dmac_desc *desc);
+void axi_dmac_queue_process(struct axi_dmac *dmac);
+void axi_dmac_abort(struct axi_dmac *dmac);
 int32_t axi_dmac_transfer(struct axi_dmac *dmac,
 			  uint32_t address, uint32_t size);
 int32_t axi_dmac_init(struct axi_dmac **adc_core,
@@ -49,6 +49,7 @@ significant delays */
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sleep.h>
 #include <inttypes.h>
 
@@ -63,6 +64,7 @@ significant delays */
 const struct spi_platform_ops spi_eng_platform_ops = {
 	.spi_ops_init = &spi_engine_init,
 	.spi_ops_write_and_read = &spi_engine_write_and_read,
+	.spi_ops_transfer = &spi_engine_transfer_msgs,
 	.spi_ops_remove = &spi_engine_remove
 };
 
@@ -651,6 +653,7 @@ int32_t spi_engine_init(struct spi_desc **desc,
 	(*desc)->extra = eng_desc;
 
 	eng_desc->offload_config = OFFLOAD_DISABLED;
+	eng_desc->xfer_prog = NULL;
 	eng_desc->spi_engine_baseaddr = spi_engine_init->spi_engine_baseaddr;
 	eng_desc->type = spi_engine_init->type;
 	eng_desc->cs_delay = spi_engine_init->cs_delay;
@@ -681,73 +684,406 @@ int32_t spi_engine_init(struct spi_desc **desc,
 }
 
 /**
- * @brief Write/read on the spi interface
+ * @brief Add a command to a compiled command stream
+ *
+ * @param cmds Command stream. If NULL, only the commands are counted
+ * @param no_cmds Number of commands in the stream, incremented
+ * @param cmd Command to be added
+ */
+static void spi_engine_emit_cmd(uint32_t *cmds,
+				uint32_t *no_cmds,
+				uint32_t cmd)
+{
+	if (cmds)
+		cmds[*no_cmds] = cmd;
+	(*no_cmds)++;
+}
+
+/**
+ * @brief Compile a multi segment message into one engine command stream
  *
  * @param desc Decriptor containing SPI interface parameters
- * @param data Pointer to data buffer
- * @param bytes_number Number of bytes to transfer
+ * @param msgs Array of message segments
+ * @param len Number of segments
+ * @param cmds Command stream. If NULL, only the commands are counted
+ * @return uint32_t Number of commands in the stream
+ */
+static uint32_t spi_engine_compile_msgs(struct spi_desc *desc,
+					struct spi_msg *msgs,
+					uint32_t len,
+					uint32_t *cmds)
+{
+	struct spi_engine_desc	*eng_desc;
+	uint32_t		no_cmds = 0;
+	uint32_t		sleep_units;
+	uint32_t		words;
+	uint32_t		chunk;
+	uint32_t		i;
+	bool			cs_asserted = false;
+
+	eng_desc = desc->extra;
+
+	spi_engine_emit_cmd(cmds, &no_cmds,
+			    SPI_ENGINE_CMD_CONFIG(SPI_ENGINE_CMD_REG_CONFIG,
+					    desc->mode));
+	spi_engine_emit_cmd(cmds, &no_cmds,
+			    SPI_ENGINE_CMD_CONFIG(
+				    SPI_ENGINE_CMD_DATA_TRANSFER_LEN,
+				    eng_desc->data_width));
+	spi_engine_emit_cmd(cmds, &no_cmds,
+			    SPI_ENGINE_CMD_CONFIG(SPI_ENGINE_CMD_REG_CLK_DIV,
+					    eng_desc->clk_div));
+
+	for (i = 0; i < len; i++) {
+		if (!cs_asserted) {
+			spi_engine_emit_cmd(cmds, &no_cmds,
+					    SPI_ENGINE_CMD_ASSERT(
+						    eng_desc->cs_delay,
+						    0xFF ^ BIT(desc->chip_select)));
+			cs_asserted = true;
+		}
+
+		/* A transfer instruction moves at most 256 words */
+		words = DIV_ROUND_UP(msgs[i].bytes_number,
+				     spi_get_word_lenght(eng_desc));
+		while (words) {
+			chunk = min(words, (uint32_t)256);
+			spi_engine_emit_cmd(cmds, &no_cmds,
+					    SPI_ENGINE_CMD_TRANSFER(
+						    SPI_ENGINE_INSTRUCTION_TRANSFER_RW,
+						    chunk - 1));
+			words -= chunk;
+		}
+
+		/*
+		 * Engine Wiki:
+		 *
+		 * The sleep instruction stops the execution for
+		 * (time + 1) * ((div + 1) * 2) clock cycles.
+		 */
+		sleep_units = DIV_ROUND_UP((uint64_t)msgs[i].delay_us *
+					   (eng_desc->ref_clk_hz / 1000000),
+					   (eng_desc->clk_div + 1) * 2);
+		while (sleep_units) {
+			chunk = min(sleep_units, (uint32_t)256);
+			spi_engine_emit_cmd(cmds, &no_cmds,
+					    SPI_ENGINE_CMD_SLEEP(chunk - 1));
+			sleep_units -= chunk;
+		}
+
+		if (msgs[i].cs_change && i != len - 1) {
+			spi_engine_emit_cmd(cmds, &no_cmds,
+					    SPI_ENGINE_CMD_ASSERT(
+						    eng_desc->cs_delay, 0xFF));
+			cs_asserted = false;
+		}
+	}
+
+	/* cs_change on the last segment keeps the chip select asserted */
+	if (cs_asserted && !msgs[len - 1].cs_change)
+		spi_engine_emit_cmd(cmds, &no_cmds,
+				    SPI_ENGINE_CMD_ASSERT(eng_desc->cs_delay,
+						    0xFF));
+
+	spi_engine_emit_cmd(cmds, &no_cmds, SPI_ENGINE_CMD_SYNC(_sync_id));
+
+	return no_cmds;
+}
+
+/**
+ * @brief Check if a program can run a message with the current settings
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param program Compiled program
+ * @param msgs Array of message segments
+ * @param len Number of segments
+ * @return bool true if the program matches the message shape and settings
+ */
+static bool spi_engine_program_match(struct spi_desc *desc,
+				     struct spi_engine_program *program,
+				     struct spi_msg *msgs,
+				     uint32_t len)
+{
+	struct spi_engine_desc	*eng_desc;
+	uint32_t		i;
+
+	eng_desc = desc->extra;
+
+	if (program->clk_div != eng_desc->clk_div ||
+	    program->data_width != eng_desc->data_width ||
+	    program->mode != desc->mode ||
+	    program->chip_select != desc->chip_select ||
+	    program->no_segs != len)
+		return false;
+
+	for (i = 0; i < len; i++)
+		if (program->seg_bytes[i] != msgs[i].bytes_number)
+			return false;
+
+	return true;
+}
+
+/**
+ * @brief Compile a message into a reusable program
+ *
+ * The command stream and the word buffers are allocated once, here. The
+ * program can then be run any number of times, with different data buffers,
+ * for messages with the same number of segments and the same segment
+ * lengths. Delays and chip select changes are taken from msgs and are fixed
+ * at this point. The program must be rebuilt if the SPI speed, mode or word
+ * width changes.
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param program Compiled program
+ * @param msgs Array of message segments
+ * @param len Number of segments
+ * @return int32_t - SUCCESS if the program was compiled
+ *		   - -EINVAL if the message is empty
+ *		   - -ENOMEM if the memory allocation failed
+ */
+int32_t spi_engine_program_init(struct spi_desc *desc,
+				struct spi_engine_program **program,
+				struct spi_msg *msgs,
+				uint32_t len)
+{
+	struct spi_engine_program	*prog;
+	struct spi_engine_desc		*eng_desc;
+	uint8_t				word_len;
+	uint32_t			i;
+
+	if (!desc || !program || !msgs || !len)
+		return -EINVAL;
+
+	eng_desc = desc->extra;
+
+	prog = (struct spi_engine_program *)calloc(1, sizeof(*prog));
+	if (!prog)
+		return -ENOMEM;
+
+	prog->seg_bytes = (uint32_t *)calloc(len, sizeof(*prog->seg_bytes));
+	if (!prog->seg_bytes)
+		goto error;
+
+	word_len = spi_get_word_lenght(eng_desc);
+	for (i = 0; i < len; i++) {
+		prog->seg_bytes[i] = msgs[i].bytes_number;
+		prog->no_words += DIV_ROUND_UP(msgs[i].bytes_number, word_len);
+	}
+	prog->no_segs = len;
+
+	prog->no_cmds = spi_engine_compile_msgs(desc, msgs, len, NULL);
+	prog->cmds = (uint32_t *)calloc(prog->no_cmds, sizeof(*prog->cmds));
+	prog->tx_words = (uint32_t *)calloc(prog->no_words + 1,
+					    sizeof(*prog->tx_words));
+	prog->rx_words = (uint32_t *)calloc(prog->no_words + 1,
+					    sizeof(*prog->rx_words));
+	if (!prog->cmds || !prog->tx_words || !prog->rx_words)
+		goto error;
+	spi_engine_compile_msgs(desc, msgs, len, prog->cmds);
+
+	prog->clk_div = eng_desc->clk_div;
+	prog->data_width = eng_desc->data_width;
+	prog->mode = desc->mode;
+	prog->chip_select = desc->chip_select;
+
+	*program = prog;
+
+	return SUCCESS;
+
+error:
+	spi_engine_program_remove(prog);
+
+	return -ENOMEM;
+}
+
+/**
+ * @brief Run a compiled program
+ *
+ * The command, SDO and SDI FIFOs are serviced while the engine runs, so the
+ * message length is not bound by the FIFO depths. No memory is allocated.
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param program Program compiled by spi_engine_program_init()
+ * @param msgs Array of message segments, holding the data buffers. It must
+ *	       have the shape the program was compiled for
  * @return int32_t - SUCCESS if the transfer finished
- *		   - FAILURE if the memory allocation or transfer failed
+ *		   - -EINVAL if the message or the settings do not match the
+ *		     program
  */
-int32_t spi_engine_write_and_read(struct spi_desc *desc,
-				  uint8_t *data,
-				  uint16_t bytes_number)
+int32_t spi_engine_program_run(struct spi_desc *desc,
+			       struct spi_engine_program *program,
+			       struct spi_msg *msgs)
 {
-	uint8_t 		i;
-	uint8_t 		word_len;
-	uint8_t 		words_number;
-	int32_t 		ret;
-	struct spi_engine_msg	msg;
-	struct spi_engine_desc	*desc_extra;
+	struct spi_engine_desc	*eng_desc;
+	uint32_t		cmd_idx = 0;
+	uint32_t		tx_idx = 0;
+	uint32_t		rx_idx = 0;
+	uint32_t		room;
+	uint32_t		sync_id;
+	uint32_t		word;
+	uint32_t		i, j;
+	uint8_t			word_len;
 
-	desc_extra = desc->extra;
+	if (!desc || !program || !msgs)
+		return -EINVAL;
 
-	/* If we want to access SPI interface and SPI engine offload module was
-	 * activated, we need to disable it
-	 * This is set in spi_engine_offload_init() */
-	desc_extra->offload_config = OFFLOAD_DISABLED;
-	/* This is set in spi_engine_offload_transfer() */
-	spi_engine_write(desc_extra, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
+	if (!spi_engine_program_match(desc, program, msgs, program->no_segs))
+		return -EINVAL;
 
-	words_number = spi_get_words_number(desc_extra, bytes_number);
+	eng_desc = desc->extra;
 
-	msg.cmds = (spi_engine_cmd_queue*)malloc(sizeof(*msg.cmds));
-	if (!msg.cmds)
-		return FAILURE;
+	/* The FIFO interface is not available while offload is running */
+	eng_desc->offload_config = OFFLOAD_DISABLED;
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
+
+	/* The stream ends with the SYNC command, give it the current id */
+	program->cmds[program->no_cmds - 1] = SPI_ENGINE_CMD_SYNC(_sync_id);
+
+	/* Pack the bytes into engine WORDS, each segment starts a new word */
+	word_len = spi_get_word_lenght(eng_desc);
+	memset(program->tx_words, 0,
+	       program->no_words * sizeof(*program->tx_words));
+	for (i = 0, word = 0; i < program->no_segs; i++) {
+		if (msgs[i].tx_buff)
+			for (j = 0; j < msgs[i].bytes_number; j++)
+				program->tx_words[word + j / word_len] |=
+					msgs[i].tx_buff[j] <<
+					(eng_desc->data_width -
+					 (j % word_len + 1) * 8);
+		word += DIV_ROUND_UP(msgs[i].bytes_number, word_len);
+	}
 
-	msg.tx_buf =(uint32_t*)calloc(words_number, sizeof(msg.tx_buf[0]));
-	msg.rx_buf =(uint32_t*)calloc(words_number, sizeof(msg.rx_buf[0]));
-	msg.length = words_number;
+	while (cmd_idx < program->no_cmds || tx_idx < program->no_words ||
+	       rx_idx < program->no_words) {
+		spi_engine_read(eng_desc, SPI_ENGINE_REG_CMD_FIFO_ROOM, &room);
+		for (; room && cmd_idx < program->no_cmds; room--)
+			spi_engine_write(eng_desc, SPI_ENGINE_REG_CMD_FIFO,
+					 program->cmds[cmd_idx++]);
+
+		spi_engine_read(eng_desc, SPI_ENGINE_REG_SDO_FIFO_ROOM, &room);
+		for (; room && tx_idx < program->no_words; room--)
+			spi_engine_write(eng_desc, SPI_ENGINE_REG_SDO_DATA_FIFO,
+					 program->tx_words[tx_idx++]);
+
+		spi_engine_read(eng_desc, SPI_ENGINE_REG_SDI_FIFO_LEVEL, &room);
+		for (; room && rx_idx < program->no_words; room--)
+			spi_engine_read(eng_desc, SPI_ENGINE_REG_SDI_DATA_FIFO,
+					&program->rx_words[rx_idx++]);
+	}
 
-	/* Get the length of transfered word */
-	word_len = spi_get_word_lenght(desc_extra);
+	/* Wait for the end sync signal */
+	do {
+		spi_engine_read(eng_desc, SPI_ENGINE_REG_SYNC_ID, &sync_id);
+	} while (sync_id != _sync_id);
+	_sync_id++;
+
+	for (i = 0, word = 0; i < program->no_segs; i++) {
+		if (msgs[i].rx_buff)
+			for (j = 0; j < msgs[i].bytes_number; j++)
+				msgs[i].rx_buff[j] =
+					program->rx_words[word + j / word_len] >>
+					(eng_desc->data_width -
+					 (j % word_len + 1) * 8);
+		word += DIV_ROUND_UP(msgs[i].bytes_number, word_len);
+	}
 
-	/* Make sure the CS is HIGH before starting a transaction */
-	msg.cmds->next = NULL;
-	msg.cmds->cmd = CS_HIGH;
-	spi_engine_queue_add_cmd(&msg.cmds, CS_LOW);
-	spi_engine_queue_add_cmd(&msg.cmds, WRITE_READ(bytes_number));
-	spi_engine_queue_add_cmd(&msg.cmds, CS_HIGH);
+	return SUCCESS;
+}
 
-	/* Pack the bytes into engine WORDS */
-	for (i = 0; i < bytes_number; i++)
-		msg.tx_buf[i / word_len] |= data[i] << (desc_extra->data_width-
-							(i % word_len + 1) * 8);
+/**
+ * @brief Free the resources allocated by spi_engine_program_init().
+ *
+ * @param program Compiled program
+ * @return int32_t This function allways returns SUCCESS
+ */
+int32_t spi_engine_program_remove(struct spi_engine_program *program)
+{
+	if (!program)
+		return SUCCESS;
 
-	ret = spi_engine_transfer_message(desc, &msg);
+	free(program->cmds);
+	free(program->tx_words);
+	free(program->rx_words);
+	free(program->seg_bytes);
+	free(program);
 
-	for (i = 0; i < bytes_number; i++)
-		data[i] = msg.rx_buf[(i) / word_len] >>
-			  (desc_extra->data_width -
-			   ((i) % word_len + 1) * 8);
+	return SUCCESS;
+}
 
-	spi_engine_queue_free(&msg.cmds);
-	free(msg.tx_buf);
-	free(msg.rx_buf);
+/**
+ * @brief Transfer a message made of multiple segments
+ *
+ * The message is compiled into a program that is run once. Callers that
+ * repeat the same message should keep a program instead, see
+ * spi_engine_program_init().
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param msgs Array of message segments
+ * @param len Number of segments
+ * @return int32_t - SUCCESS if the transfer finished
+ *		   - -ENOMEM if the memory allocation failed
+ */
+int32_t spi_engine_transfer_msgs(struct spi_desc *desc,
+				 struct spi_msg *msgs,
+				 uint32_t len)
+{
+	struct spi_engine_program	*program;
+	int32_t				ret;
+
+	ret = spi_engine_program_init(desc, &program, msgs, len);
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = spi_engine_program_run(desc, program, msgs);
+
+	spi_engine_program_remove(program);
 
 	return ret;
 }
 
+/**
+ * @brief Write/read on the spi interface
+ *
+ * The program compiled for the previous call is kept in the descriptor and
+ * reused while the transfer length and the interface settings are unchanged,
+ * so register polling loops do not touch the heap.
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param data Pointer to data buffer
+ * @param bytes_number Number of bytes to transfer
+ * @return int32_t - SUCCESS if the transfer finished
+ *		   - -ENOMEM if the memory allocation failed
+ */
+int32_t spi_engine_write_and_read(struct spi_desc *desc,
+				  uint8_t *data,
+				  uint16_t bytes_number)
+{
+	int32_t 		ret;
+	struct spi_msg		msg = {
+		.tx_buff = data,
+		.rx_buff = data,
+		.bytes_number = bytes_number,
+	};
+	struct spi_engine_desc	*desc_extra;
+
+	desc_extra = desc->extra;
+
+	if (desc_extra->xfer_prog &&
+	    !spi_engine_program_match(desc, desc_extra->xfer_prog, &msg, 1)) {
+		spi_engine_program_remove(desc_extra->xfer_prog);
+		desc_extra->xfer_prog = NULL;
+	}
+
+	if (!desc_extra->xfer_prog) {
+		ret = spi_engine_program_init(desc, &desc_extra->xfer_prog,
+					      &msg, 1);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	return spi_engine_program_run(desc, desc_extra->xfer_prog, &msg);
+}
+
 /**
  * @brief Initialize the SPI engine's offload module
  *
@@ -759,7 +1095,7 @@ int32_t spi_engine_offload_init(struct spi_desc *desc,
 				const struct spi_engine_offload_init_param *param)
 {
 	struct spi_engine_desc	*eng_desc;
-	struct axi_dmac_init	dmac_init;
+	struct axi_dmac_init	dmac_init = {0};
 	uint32_t dma_flags;
 
 	eng_desc = desc->extra;
@@ -794,21 +1130,19 @@ int32_t spi_engine_offload_init(struct spi_desc *desc,
 }
 
 /**
- * @brief Initiate a SPI transfer in offload mode
+ * @brief Reset the offload module and load its command and SDO memories
  *
  * @param desc Decriptor containing SPI interface parameters
- * @param msg Offload message that get's to be transferred
- * @param no_samples Number of time the messages will be transferred
- * @return int32_t This function allways returns SUCCESS
+ * @param msg Offload message that get's to be loaded
+ * @return int32_t - SUCCESS if the program was loaded
+ *		   - FAILURE if offload is disabled or the allocation failed
  */
-int32_t spi_engine_offload_transfer(struct spi_desc *desc,
-				    struct spi_engine_offload_message msg,
-				    uint32_t no_samples)
+static int32_t spi_engine_offload_load(struct spi_desc *desc,
+				       struct spi_engine_offload_message *msg)
 {
 	struct spi_engine_msg	transfer;
 	struct spi_engine_desc	*eng_desc;
 	uint32_t 		i;
-	uint8_t 		word_length;
 
 	eng_desc = desc->extra;
 
@@ -828,19 +1162,46 @@ int32_t spi_engine_offload_transfer(struct spi_desc *desc,
 	if (!transfer.cmds)
 		return FAILURE;
 
-	transfer.tx_buf = msg.commands_data;
+	transfer.tx_buf = msg->commands_data;
 
 	/* Load the commands into the message */
 	transfer.cmds->next = NULL;
-	transfer.cmds->cmd = msg.commands[0];
+	transfer.cmds->cmd = msg->commands[0];
 	i = 1;
-	while(i < msg.no_commands) {
-		spi_engine_queue_add_cmd(&transfer.cmds, msg.commands[i++]);
+	while(i < msg->no_commands) {
+		spi_engine_queue_add_cmd(&transfer.cmds, msg->commands[i++]);
 
 	}
 
 	spi_engine_transfer_message(desc, &transfer);
 
+	spi_engine_queue_free(&transfer.cmds);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Initiate a SPI transfer in offload mode
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param msg Offload message that get's to be transferred
+ * @param no_samples Number of time the messages will be transferred
+ * @return int32_t This function allways returns SUCCESS
+ */
+int32_t spi_engine_offload_transfer(struct spi_desc *desc,
+				    struct spi_engine_offload_message msg,
+				    uint32_t no_samples)
+{
+	struct spi_engine_desc	*eng_desc;
+	uint8_t 		word_length;
+	int32_t			ret;
+
+	eng_desc = desc->extra;
+
+	ret = spi_engine_offload_load(desc, &msg);
+	if (ret != SUCCESS)
+		return ret;
+
 	/* Start transfer */
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0x0001);
 
@@ -861,7 +1222,247 @@ int32_t spi_engine_offload_transfer(struct spi_desc *desc,
 
 	usleep(1000);
 
-	spi_engine_queue_free(&transfer.cmds);
+	return SUCCESS;
+}
+
+/**
+ * @brief Completion callback of a stream block
+ *
+ * The block is given back to the DMA right away, for the next lap of the
+ * ring, so the capture never stops. If the consumer is a whole ring behind,
+ * its oldest block is being overwritten and is dropped.
+ *
+ * @param ctx The stream
+ * @param dma_desc Descriptor of the block that was filled
+ */
+static void spi_engine_offload_stream_block_done(void *ctx,
+		struct axi_dmac_desc *dma_desc)
+{
+	struct spi_engine_offload_stream	*stream = ctx;
+	struct spi_engine_desc			*eng_desc;
+
+	eng_desc = stream->spi->extra;
+
+	stream->produced++;
+	if (stream->produced - stream->consumed > stream->nb_blocks - 1) {
+		stream->consumed = stream->produced - (stream->nb_blocks - 1);
+		stream->overruns++;
+	}
+
+	if (stream->running)
+		axi_dmac_submit(eng_desc->offload_rx_dma, dma_desc);
+}
+
+/**
+ * @brief Initialize an offload stream
+ *
+ * The ring at buf_addr is split in nb_blocks blocks of block_size bytes.
+ * spi_engine_offload_init() must be called first, with OFFLOAD_RX_EN.
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param stream The stream
+ * @param param Structure containing the stream init parameters
+ * @return int32_t - SUCCESS if the stream was initialized
+ *		   - -EINVAL if the parameters are invalid
+ *		   - -ENOMEM if the memory allocation failed
+ */
+int32_t spi_engine_offload_stream_init(struct spi_desc *desc,
+				       struct spi_engine_offload_stream **stream,
+				       const struct spi_engine_offload_stream_init_param *param)
+{
+	struct spi_engine_offload_stream	*str;
+	struct spi_engine_desc			*eng_desc;
+	uint32_t				i;
+
+	if (!desc || !stream || !param || param->nb_blocks < 2 ||
+	    !param->block_size)
+		return -EINVAL;
+
+	eng_desc = desc->extra;
+	if (!(eng_desc->offload_config & OFFLOAD_RX_EN) ||
+	    !eng_desc->offload_rx_dma)
+		return -EINVAL;
+
+	str = (struct spi_engine_offload_stream *)calloc(1, sizeof(*str));
+	if (!str)
+		return -ENOMEM;
+
+	str->blocks = (struct axi_dmac_desc *)calloc(param->nb_blocks,
+			sizeof(*str->blocks));
+	if (!str->blocks) {
+		free(str);
+		return -ENOMEM;
+	}
+
+	str->spi = desc;
+	str->buf_addr = param->buf_addr;
+	str->block_size = param->block_size;
+	str->nb_blocks = param->nb_blocks;
+
+	for (i = 0; i < str->nb_blocks; i++) {
+		str->blocks[i].address = str->buf_addr + i * str->block_size;
+		str->blocks[i].x_length = str->block_size;
+		str->blocks[i].callback = spi_engine_offload_stream_block_done;
+		str->blocks[i].ctx = str;
+	}
+
+	*stream = str;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Load the offload program once and start the capture into the ring
+ *
+ * @param stream The stream
+ * @param msg Offload message, run once for each sample
+ * @return int32_t - SUCCESS if the capture started
+ *		   - -EINVAL if a block does not hold a whole number of samples
+ *		   - -EBUSY if the stream is already running
+ *		   - FAILURE if the offload program could not be loaded
+ */
+int32_t spi_engine_offload_stream_start(struct spi_engine_offload_stream *stream,
+					struct spi_engine_offload_message msg)
+{
+	struct spi_engine_desc	*eng_desc;
+	uint32_t		sample_size;
+	uint32_t		i;
+	int32_t			ret;
+
+	if (!stream)
+		return -EINVAL;
+
+	if (stream->running)
+		return -EBUSY;
+
+	eng_desc = stream->spi->extra;
+
+	ret = spi_engine_offload_load(stream->spi, &msg);
+	if (ret != SUCCESS)
+		return ret;
+
+	sample_size = spi_get_word_lenght(eng_desc) * eng_desc->offload_tx_len;
+	if (!sample_size || stream->block_size % sample_size)
+		return -EINVAL;
+
+	/* Drop a previous one shot or cyclic transfer */
+	axi_dmac_abort(eng_desc->offload_rx_dma);
+
+	stream->produced = 0;
+	stream->consumed = 0;
+	stream->overruns = 0;
+	stream->running = true;
+
+	for (i = 0; i < stream->nb_blocks; i++) {
+		ret = axi_dmac_submit(eng_desc->offload_rx_dma,
+				      &stream->blocks[i]);
+		if (ret != SUCCESS) {
+			spi_engine_offload_stream_stop(stream);
+			return ret;
+		}
+	}
+
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0x0001);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the oldest filled block, without stopping the capture
+ *
+ * The block stays owned by the consumer until spi_engine_offload_stream_put().
+ * Without a DMA interrupt, the DMA queue is also serviced here. On cached
+ * platforms the consumer must invalidate the block before reading it.
+ *
+ * @param stream The stream
+ * @param addr Address of the block
+ * @return int32_t - SUCCESS if a block was returned
+ *		   - -EAGAIN if no block is filled yet
+ *		   - -EINVAL if the stream is not running
+ */
+int32_t spi_engine_offload_stream_get(struct spi_engine_offload_stream *stream,
+				      uint32_t *addr)
+{
+	struct spi_engine_desc	*eng_desc;
+	uint32_t		seq;
+
+	if (!stream || !addr || !stream->running)
+		return -EINVAL;
+
+	eng_desc = stream->spi->extra;
+
+	axi_dmac_queue_process(eng_desc->offload_rx_dma);
+
+	seq = stream->consumed;
+	if (seq == stream->produced)
+		return -EAGAIN;
+
+	stream->reading = seq;
+	*addr = stream->buf_addr + (seq % stream->nb_blocks) * stream->block_size;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Release the block returned by spi_engine_offload_stream_get()
+ *
+ * @param stream The stream
+ * @return int32_t - SUCCESS if the block was consumed
+ *		   - -EOVERFLOW if the block was overwritten while it was read.
+ *		     Its content must be discarded
+ */
+int32_t spi_engine_offload_stream_put(struct spi_engine_offload_stream *stream)
+{
+	if (!stream)
+		return -EINVAL;
+
+	if (stream->consumed != stream->reading)
+		return -EOVERFLOW;
+
+	stream->consumed++;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stop the capture
+ *
+ * @param stream The stream
+ * @return int32_t - SUCCESS if the capture stopped
+ *		   - -EINVAL if the stream is NULL
+ */
+int32_t spi_engine_offload_stream_stop(struct spi_engine_offload_stream *stream)
+{
+	struct spi_engine_desc	*eng_desc;
+
+	if (!stream)
+		return -EINVAL;
+
+	eng_desc = stream->spi->extra;
+
+	stream->running = false;
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
+	axi_dmac_abort(eng_desc->offload_rx_dma);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by spi_engine_offload_stream_init().
+ *
+ * @param stream The stream
+ * @return int32_t This function allways returns SUCCESS
+ */
+int32_t spi_engine_offload_stream_remove(struct spi_engine_offload_stream *stream)
+{
+	if (!stream)
+		return SUCCESS;
+
+	if (stream->running)
+		spi_engine_offload_stream_stop(stream);
+
+	free(stream->blocks);
+	free(stream);
 
 	return SUCCESS;
 }
@@ -882,6 +1483,7 @@ int32_t spi_engine_remove(struct spi_desc *desc)
 		axi_dmac_remove(eng_desc->offload_tx_dma);
 	if(eng_desc->offload_config & OFFLOAD_RX_EN)
 		axi_dmac_remove(eng_desc->offload_rx_dma);
+	spi_engine_program_remove(eng_desc->xfer_prog);
 	free(desc->extra);
 	free(desc);
 
@@ -132,6 +132,8 @@ struct spi_engine_desc {
 	uint8_t			data_width;
 	/** The maximum data width supported by the engine */
 	uint8_t 		max_data_width;
+	/** Program of the last spi_engine_write_and_read() call */
+	struct spi_engine_program	*xfer_prog;
 };
 
 
@@ -170,6 +172,75 @@ struct spi_engine_offload_message {
 	uint32_t rx_addr;
 };
 
+/**
+ * @struct spi_engine_offload_stream_init_param
+ * @brief  Structure containing the init parameters of an offload stream
+ */
+struct spi_engine_offload_stream_init_param {
+	/** Address of the ring buffer, DMA reachable */
+	uint32_t	buf_addr;
+	/** Size in bytes of a block, a whole number of samples */
+	uint32_t	block_size;
+	/** Number of blocks of the ring, at least 2 */
+	uint32_t	nb_blocks;
+};
+
+/**
+ * @struct spi_engine_offload_stream
+ * @brief  Continuous offload capture into a ring of DMA blocks
+ */
+struct spi_engine_offload_stream {
+	/** SPI engine descriptor running the offload */
+	struct spi_desc		*spi;
+	/** DMA descriptors, one for each block */
+	struct axi_dmac_desc	*blocks;
+	/** Address of the ring buffer */
+	uint32_t		buf_addr;
+	/** Size in bytes of a block */
+	uint32_t		block_size;
+	/** Number of blocks of the ring */
+	uint32_t		nb_blocks;
+	/** Number of blocks filled by the DMA, producer index */
+	volatile uint32_t	produced;
+	/** Number of blocks released by the consumer, consumer index */
+	volatile uint32_t	consumed;
+	/** Index of the block returned by the last get */
+	uint32_t		reading;
+	/** Number of blocks dropped because the consumer was too slow */
+	volatile uint32_t	overruns;
+	/** Set while the capture runs */
+	volatile bool		running;
+};
+
+/**
+ * @struct spi_engine_program
+ * @brief  Precompiled command stream for messages of a fixed shape
+ */
+struct spi_engine_program {
+	/** Engine commands, ending with the SYNC command */
+	uint32_t	*cmds;
+	/** Number of engine commands */
+	uint32_t	no_cmds;
+	/** SDO words */
+	uint32_t	*tx_words;
+	/** SDI words */
+	uint32_t	*rx_words;
+	/** Number of SDO and SDI words */
+	uint32_t	no_words;
+	/** Number of bytes of each segment */
+	uint32_t	*seg_bytes;
+	/** Number of segments */
+	uint32_t	no_segs;
+	/** Clock divider the program was compiled for */
+	uint32_t	clk_div;
+	/** Word width the program was compiled for */
+	uint8_t		data_width;
+	/** SPI mode the program was compiled for */
+	enum spi_mode	mode;
+	/** Chip select the program was compiled for */
+	uint8_t		chip_select;
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -197,6 +268,25 @@ int32_t spi_engine_write_and_read(struct spi_desc *desc,
 				  uint8_t *data,
 				  uint16_t bytes_number);
 
+/* Transfer a message made of multiple segments using the SPI engine */
+int32_t spi_engine_transfer_msgs(struct spi_desc *desc,
+				 struct spi_msg *msgs,
+				 uint32_t len);
+
+/* Compile a message into a reusable program */
+int32_t spi_engine_program_init(struct spi_desc *desc,
+				struct spi_engine_program **program,
+				struct spi_msg *msgs,
+				uint32_t len);
+
+/* Run a compiled program */
+int32_t spi_engine_program_run(struct spi_desc *desc,
+			       struct spi_engine_program *program,
+			       struct spi_msg *msgs);
+
+/* Free the resources used by a compiled program */
+int32_t spi_engine_program_remove(struct spi_engine_program *program);
+
 /* Free the resources used by the SPI engine device */
 int32_t spi_engine_remove(struct spi_desc *desc);
 
@@ -209,6 +299,28 @@ int32_t spi_engine_offload_transfer(struct spi_desc *desc,
 				    struct spi_engine_offload_message msg,
 				    uint32_t no_samples);
 
+/* Initialize a continuous offload capture */
+int32_t spi_engine_offload_stream_init(struct spi_desc *desc,
+				       struct spi_engine_offload_stream **stream,
+				       const struct spi_engine_offload_stream_init_param *param);
+
+/* Load the offload program and start the capture */
+int32_t spi_engine_offload_stream_start(struct spi_engine_offload_stream *stream,
+					struct spi_engine_offload_message msg);
+
+/* Get the oldest captured block */
+int32_t spi_engine_offload_stream_get(struct spi_engine_offload_stream *stream,
+				      uint32_t *addr);
+
+/* Release the block returned by spi_engine_offload_stream_get() */
+int32_t spi_engine_offload_stream_put(struct spi_engine_offload_stream *stream);
+
+/* Stop the capture */
+int32_t spi_engine_offload_stream_stop(struct spi_engine_offload_stream *stream);
+
+/* Free the resources used by an offload stream */
+int32_t spi_engine_offload_stream_remove(struct spi_engine_offload_stream *stream);
+
 /* Set SPI transfer width */
 int32_t spi_engine_set_transfer_width(struct spi_desc *desc,
 				      uint8_t data_wdith);
@@ -182,3 +182,166 @@ int32_t gpio_get_value(struct gpio_desc *desc,
 	else
 		return SUCCESS;
 }
+
+/**
+ * @brief Obtain the descriptors of several GPIOs at once.
+ *
+ * Platforms that support it group the GPIOs so that gpio_set_values() and
+ * gpio_get_values() access them together. All the GPIOs must use the same
+ * platform ops.
+ * @param descs - Array where the GPIO descriptors are stored.
+ * @param params - Array of GPIO initialization parameters.
+ * @param nb_gpios - Number of GPIOs.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t gpio_get_bulk(struct gpio_desc **descs,
+		      const struct gpio_init_param *params,
+		      uint32_t nb_gpios)
+{
+	const struct gpio_platform_ops *ops;
+	uint32_t i;
+	int32_t ret;
+
+	if (!descs || !params || !nb_gpios)
+		return -EINVAL;
+
+	ops = params[0].platform_ops;
+	for (i = 1; i < nb_gpios; i++)
+		if (params[i].platform_ops != ops)
+			return -EINVAL;
+
+	if (!ops->gpio_ops_get_bulk) {
+		for (i = 0; i < nb_gpios; i++) {
+			ret = gpio_get(&descs[i], &params[i]);
+			if (ret) {
+				while (i--)
+					gpio_remove(descs[i]);
+				return ret;
+			}
+		}
+
+		return SUCCESS;
+	}
+
+	ret = ops->gpio_ops_get_bulk(descs, params, nb_gpios);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < nb_gpios; i++)
+		descs[i]->platform_ops = ops;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the platform ops shared by all the descriptors of a bulk access.
+ * @param descs - Array of GPIO descriptors.
+ * @param nb_gpios - Number of GPIOs.
+ * @return The platform ops, or NULL if a descriptor is missing or the
+ * descriptors use different platform ops.
+ */
+static const struct gpio_platform_ops *gpio_bulk_ops(struct gpio_desc **descs,
+		uint32_t nb_gpios)
+{
+	uint32_t i;
+
+	if (!descs[0])
+		return NULL;
+
+	for (i = 1; i < nb_gpios; i++)
+		if (!descs[i] || descs[i]->platform_ops != descs[0]->platform_ops)
+			return NULL;
+
+	return descs[0]->platform_ops;
+}
+
+/**
+ * @brief Set the values of several GPIOs.
+ * @param descs - Array of GPIO descriptors. NULL descriptors are skipped.
+ * @param nb_gpios - Number of GPIOs.
+ * @param values - Array with the value of each GPIO.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t gpio_set_values(struct gpio_desc **descs,
+			uint32_t nb_gpios,
+			const uint8_t *values)
+{
+	const struct gpio_platform_ops *ops;
+	uint32_t i;
+	int32_t ret;
+
+	if (!descs || !values || !nb_gpios)
+		return -EINVAL;
+
+	ops = gpio_bulk_ops(descs, nb_gpios);
+	if (ops && ops->gpio_ops_set_values)
+		return ops->gpio_ops_set_values(descs, nb_gpios, values);
+
+	for (i = 0; i < nb_gpios; i++) {
+		ret = gpio_set_value(descs[i], values[i]);
+		if (ret)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the values of several GPIOs.
+ * @param descs - Array of GPIO descriptors. NULL descriptors are skipped.
+ * @param nb_gpios - Number of GPIOs.
+ * @param values - Array where the value of each GPIO is stored.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t gpio_get_values(struct gpio_desc **descs,
+			uint32_t nb_gpios,
+			uint8_t *values)
+{
+	const struct gpio_platform_ops *ops;
+	uint32_t i;
+	int32_t ret;
+
+	if (!descs || !values || !nb_gpios)
+		return -EINVAL;
+
+	ops = gpio_bulk_ops(descs, nb_gpios);
+	if (ops && ops->gpio_ops_get_values)
+		return ops->gpio_ops_get_values(descs, nb_gpios, values);
+
+	for (i = 0; i < nb_gpios; i++) {
+		ret = gpio_get_value(descs[i], &values[i]);
+		if (ret)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Wait for an edge on the specified GPIO.
+ *
+ * Edge detection is enabled by the first call and stays enabled, so edges
+ * that happen between two calls are not lost. A call with a timeout of 0
+ * only returns an edge that was already detected.
+ * @param desc - The GPIO descriptor.
+ * @param edge - The edge to wait for. Other edges are discarded.
+ * @param timeout_us - Timeout in microseconds.
+ * @param event - Where the detected edge is stored. May be NULL.
+ * @return SUCCESS in case of success, -ETIMEDOUT if no edge was detected in
+ * time, -ENOSYS if the platform can't detect edges, other negative error code
+ * otherwise.
+ */
+int32_t gpio_wait_edge(struct gpio_desc *desc,
+		       enum gpio_edge edge,
+		       uint32_t timeout_us,
+		       struct gpio_event *event)
+{
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->platform_ops->gpio_ops_wait_edge)
+		return -ENOSYS;
+
+	return desc->platform_ops->gpio_ops_wait_edge(desc, edge, timeout_us,
+			event);
+}
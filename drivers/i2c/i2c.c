@@ -109,3 +109,65 @@ int32_t i2c_read(struct i2c_desc *desc,
 	return desc->platform_ops->i2c_ops_read(desc, data, bytes_number,
 						stop_bit);
 }
+
+/**
+ * @brief Issue the messages of a transfer one by one through the write and
+ * read ops of the platform.
+ * @param desc - The I2C descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t i2c_transfer_emulated(struct i2c_desc *desc,
+				     struct i2c_transfer_msg *msgs,
+				     uint32_t len)
+{
+	uint8_t stop_bit;
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < len; i++)
+		if (msgs[i].bytes_number > UINT8_MAX)
+			return -EINVAL;
+
+	for (i = 0; i < len; i++) {
+		stop_bit = (i == len - 1) || (msgs[i].flags & I2C_MSG_STOP);
+		if (msgs[i].flags & I2C_MSG_RD)
+			ret = desc->platform_ops->i2c_ops_read(desc,
+							       msgs[i].buff,
+							       msgs[i].bytes_number,
+							       stop_bit);
+		else
+			ret = desc->platform_ops->i2c_ops_write(desc,
+								msgs[i].buff,
+								msgs[i].bytes_number,
+								stop_bit);
+		if (ret)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Issue several messages to a slave device as one transaction.
+ *
+ * The messages are separated by repeated start conditions, so a register
+ * address write followed by a data read is done without releasing the bus.
+ * @param desc - The I2C descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t i2c_transfer(struct i2c_desc *desc,
+		     struct i2c_transfer_msg *msgs,
+		     uint32_t len)
+{
+	if (!desc || !msgs || !len)
+		return -EINVAL;
+
+	if (desc->platform_ops->i2c_ops_transfer)
+		return desc->platform_ops->i2c_ops_transfer(desc, msgs, len);
+
+	return i2c_transfer_emulated(desc, msgs, len);
+}
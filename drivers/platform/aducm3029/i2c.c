@@ -246,3 +246,49 @@ int32_t i2c_read(struct i2c_desc *desc,
 
 	return SUCCESS;
 }
+
+/**
+ * @brief Issue several messages to a slave device as one transaction.
+ *
+ * A write message directly followed by a read message is sent as the
+ * prologue of the read, so a register read takes a single driver transaction.
+ * @param desc - The I2C descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t i2c_transfer(struct i2c_desc *desc,
+		     struct i2c_transfer_msg *msgs,
+		     uint32_t len)
+{
+	ADI_I2C_TRANSACTION trans[1];
+	uint32_t errors;
+	uint32_t i;
+
+	if (!desc || !msgs || !len)
+		return -EINVAL;
+
+	if (SUCCESS != set_transmission_configuration(desc))
+		return FAILURE;
+
+	for (i = 0; i < len; i++) {
+		trans->pPrologue = 0;
+		trans->nPrologueSize = 0;
+		if (!(msgs[i].flags & (I2C_MSG_RD | I2C_MSG_STOP)) &&
+		    i + 1 < len && (msgs[i + 1].flags & I2C_MSG_RD)) {
+			trans->pPrologue = msgs[i].buff;
+			trans->nPrologueSize = msgs[i].bytes_number;
+			i++;
+		}
+		trans->pData = msgs[i].buff;
+		trans->nDataSize = msgs[i].bytes_number;
+		trans->bReadNotWrite = !!(msgs[i].flags & I2C_MSG_RD);
+		trans->bRepeatStart = (i != len - 1) &&
+				      !(msgs[i].flags & I2C_MSG_STOP);
+		if (ADI_I2C_SUCCESS != adi_i2c_ReadWrite(i2c_handler, trans,
+				&errors))
+			return FAILURE;
+	}
+
+	return SUCCESS;
+}
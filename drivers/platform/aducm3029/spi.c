@@ -44,11 +44,15 @@
 #include "spi_extra.h"
 #include "spi.h"
 #include "error.h"
+#include "delay.h"
 #include <stdlib.h>
+#include <string.h>
 #include "util.h"
 
 #define	NB_SPI_DEVICES	3
 #define	MAX_CS_NUMBER	3
+/** Segments up to this size are gathered on the stack by spi_transfer() */
+#define SPI_TRANSFER_BUFF_SIZE	64
 
 /******************************************************************************/
 /*****************************  Variables   **********************************/
@@ -278,3 +282,84 @@ int32_t spi_write_and_read(struct spi_desc *desc,
 	return SUCCESS;
 }
 
+/**
+ * @brief Transfer a message made of several segments.
+ *
+ * The driver asserts the chip select for each transaction, so the segments
+ * that share a chip select assertion are gathered in one buffer and sent with
+ * a single spi_write_and_read(). A segment with a delay also ends the chip
+ * select assertion and cs_change on the last segment is ignored.
+ * @param desc - The SPI descriptor.
+ * @param msgs - Array of message segments.
+ * @param len - Number of segments.
+ * @return SUCCESS in case of success, -EINVAL if the segments under one chip
+ * select assertion are larger than UINT16_MAX bytes, other negative error
+ * code otherwise.
+ */
+int32_t spi_transfer(struct spi_desc *desc,
+		     struct spi_msg *msgs,
+		     uint32_t len)
+{
+	uint8_t small_buff[SPI_TRANSFER_BUFF_SIZE];
+	uint32_t first, last;
+	uint32_t offset;
+	uint32_t size;
+	uint8_t *buff;
+	uint32_t i;
+	int32_t ret;
+
+	if (!desc || !msgs || !len)
+		return -EINVAL;
+
+	for (first = 0; first < len; first = last + 1) {
+		size = 0;
+		for (last = first; ; last++) {
+			size += msgs[last].bytes_number;
+			if (last == len - 1 || msgs[last].cs_change ||
+			    msgs[last].delay_us)
+				break;
+		}
+		if (size > UINT16_MAX)
+			return -EINVAL;
+
+		if (size) {
+			/* A single segment is transferred in place */
+			if (first == last && msgs[first].rx_buff)
+				buff = msgs[first].rx_buff;
+			else if (size <= sizeof(small_buff))
+				buff = small_buff;
+			else
+				buff = malloc(size);
+			if (!buff)
+				return -ENOMEM;
+
+			for (i = first, offset = 0; i <= last;
+			     offset += msgs[i++].bytes_number) {
+				if (!msgs[i].tx_buff)
+					memset(buff + offset, 0, msgs[i].bytes_number);
+				else if (msgs[i].tx_buff != buff + offset)
+					memcpy(buff + offset, msgs[i].tx_buff,
+					       msgs[i].bytes_number);
+			}
+
+			ret = spi_write_and_read(desc, buff, size);
+
+			for (i = first, offset = 0; !ret && i <= last;
+			     offset += msgs[i++].bytes_number)
+				if (msgs[i].rx_buff && msgs[i].rx_buff != buff + offset)
+					memcpy(msgs[i].rx_buff, buff + offset,
+					       msgs[i].bytes_number);
+
+			if (buff != small_buff && buff != msgs[first].rx_buff)
+				free(buff);
+			if (ret)
+				return ret;
+		}
+
+		if (msgs[last].delay_us)
+			udelay(msgs[last].delay_us);
+	}
+
+	return SUCCESS;
+}
+
@@ -77,3 +77,40 @@ int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 	return SUCCESS;
 }
 
+/**
+ * @brief AXI IO Altera specific read of consecutive registers.
+ * @param base - Base address
+ * @param offset - Address offset of the first register
+ * @param data - Location where read data will be stored
+ * @param nb_regs - Number of registers to read
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_read_bulk(uint32_t base, uint32_t offset, uint32_t *data,
+			 uint32_t nb_regs)
+{
+	uint32_t i;
+
+	for (i = 0; i < nb_regs; i++)
+		data[i] = IORD_32DIRECT(base, offset + i * 4);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO Altera specific write of consecutive registers.
+ * @param base - Base address
+ * @param offset - Address offset of the first register
+ * @param data - Data to be written
+ * @param nb_regs - Number of registers to write
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write_bulk(uint32_t base, uint32_t offset, const uint32_t *data,
+			  uint32_t nb_regs)
+{
+	uint32_t i;
+
+	for (i = 0; i < nb_regs; i++)
+		IOWR_32DIRECT(base, offset + i * 4, data[i]);
+
+	return SUCCESS;
+}
@@ -200,3 +200,121 @@ int32_t gpio_get_value(struct gpio_desc *desc,
 
 	return SUCCESS;
 }
+
+/**
+ * @brief Get several GPIOs at once.
+ *
+ * Not supported by this platform.
+ * @param descs - Array where the GPIO descriptors are stored.
+ * @param params - Array of GPIO initialization parameters.
+ * @param nb_gpios - Number of GPIOs.
+ * @return -ENOSYS.
+ */
+int32_t gpio_get_bulk(struct gpio_desc **descs,
+		      const struct gpio_init_param *params,
+		      uint32_t nb_gpios)
+{
+	if (descs) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (params) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (nb_gpios) {
+		// Unused variable - fix compiler warning
+	}
+
+	return -ENOSYS;
+}
+
+/**
+ * @brief Set the values of several GPIOs.
+ *
+ * Not supported by this platform.
+ * @param descs - Array of GPIO descriptors.
+ * @param nb_gpios - Number of GPIOs.
+ * @param values - Array with the value of each GPIO.
+ * @return -ENOSYS.
+ */
+int32_t gpio_set_values(struct gpio_desc **descs,
+			uint32_t nb_gpios,
+			const uint8_t *values)
+{
+	if (descs) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (nb_gpios) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (values) {
+		// Unused variable - fix compiler warning
+	}
+
+	return -ENOSYS;
+}
+
+/**
+ * @brief Get the values of several GPIOs.
+ *
+ * Not supported by this platform.
+ * @param descs - Array of GPIO descriptors.
+ * @param nb_gpios - Number of GPIOs.
+ * @param values - Array where the value of each GPIO is stored.
+ * @return -ENOSYS.
+ */
+int32_t gpio_get_values(struct gpio_desc **descs,
+			uint32_t nb_gpios,
+			uint8_t *values)
+{
+	if (descs) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (nb_gpios) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (values) {
+		// Unused variable - fix compiler warning
+	}
+
+	return -ENOSYS;
+}
+
+/**
+ * @brief Wait for an edge on the specified GPIO.
+ *
+ * Not supported by this platform.
+ * @param desc - The GPIO descriptor.
+ * @param edge - The edge to wait for.
+ * @param timeout_us - Timeout in microseconds.
+ * @param event - Where the detected edge is stored.
+ * @return -ENOSYS.
+ */
+int32_t gpio_wait_edge(struct gpio_desc *desc,
+		       enum gpio_edge edge,
+		       uint32_t timeout_us,
+		       struct gpio_event *event)
+{
+	if (desc) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (edge) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (timeout_us) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (event) {
+		// Unused variable - fix compiler warning
+	}
+
+	return -ENOSYS;
+}
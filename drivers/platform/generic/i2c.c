@@ -148,3 +148,29 @@ int32_t i2c_read(struct i2c_desc *desc,
 
 	return SUCCESS;
 }
+
+/**
+ * @brief Issue several messages to a slave device as one transaction.
+ * @param desc - The I2C descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t i2c_transfer(struct i2c_desc *desc,
+		     struct i2c_transfer_msg *msgs,
+		     uint32_t len)
+{
+	if (desc) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (msgs) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (len) {
+		// Unused variable - fix compiler warning
+	}
+
+	return SUCCESS;
+}
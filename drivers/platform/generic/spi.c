@@ -106,3 +106,29 @@ int32_t spi_write_and_read(struct spi_desc *desc,
 
 	return SUCCESS;
 }
+
+/**
+ * @brief Transfer a message made of several segments.
+ * @param desc - The SPI descriptor.
+ * @param msgs - Array of message segments.
+ * @param len - Number of segments.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t spi_transfer(struct spi_desc *desc,
+		     struct spi_msg *msgs,
+		     uint32_t len)
+{
+	if (desc) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (msgs) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (len) {
+		// Unused variable - fix compiler warning
+	}
+
+	return SUCCESS;
+}
@@ -44,73 +44,166 @@
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/mman.h>
 #include "error.h"
+#include "util.h"
 #include "axi_io.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define AXI_IO_MAX_MAPPINGS	16
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct axi_io_mapping
+ * @brief Register window kept mapped for the lifetime of the process.
+ */
+struct axi_io_mapping {
+	/** UIO index or base address, as passed to axi_io_read/write */
+	uint32_t	base;
+	/** Mapped address corresponding to base */
+	uint8_t		*addr;
+	/** Start of the mapping */
+	void		*map_addr;
+	/** Size of the mapping */
+	size_t		map_size;
+};
+
+static struct axi_io_mapping	mappings[AXI_IO_MAX_MAPPINGS];
+static uint32_t			nb_mappings;
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+#ifndef DEVMEM
 /**
- * @brief AXI IO through UIO read/write function.
+ * @brief Get the size of the first memory region of an UIO device.
  * @param base - UIO index (/dev/uioX).
- * @param offset - Address offset.
- * @param read - Location where read data will be stored.
- * @param write - Data to be written.
+ * @return Size of the region, or 0 if it can't be read.
+ */
+static size_t uio_get_map_size(uint32_t base)
+{
+	char buf[64];
+	FILE *f;
+	unsigned long size;
+
+	sprintf(buf, "/sys/class/uio/uio%"PRIu32"/maps/map0/size", base);
+	f = fopen(buf, "r");
+	if (!f)
+		return 0;
+
+	if (fscanf(f, "%lx", &size) != 1)
+		size = 0;
+	fclose(f);
+
+	return size;
+}
+#endif
+
+/**
+ * @brief Map a register window.
+ * @param base - UIO index (/dev/uioX)/base address.
+ * @param size - Minimum number of bytes to be accessible from base.
+ * @param map - Mapping to be filled.
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
-static int32_t uio_read_write(uint32_t base, uint32_t offset, uint32_t *read,
-			      uint32_t *write)
+static int32_t axi_io_map(uint32_t base, size_t size,
+			  struct axi_io_mapping *map)
 {
 	char buf[32];
-	int ret;
-	int uio_fd;
-	int32_t status = SUCCESS;
-	void *uio_addr;
+	size_t page_size;
+	size_t map_size;
+	off_t map_offset;
+	size_t delta;
+	void *addr;
+	int fd;
 
+	page_size = sysconf(_SC_PAGESIZE);
+#ifdef DEVMEM
+	strcpy(buf, "/dev/mem");
+	map_offset = base & ~(page_size - 1);
+	delta = base - map_offset;
+	fd = open(buf, O_RDWR | O_SYNC);
+#else
 	sprintf(buf, "/dev/uio%"PRIu32"", base);
-
-	uio_fd = open(buf, O_RDWR);
-	if (uio_fd < 0) {
+	map_offset = 0;
+	delta = 0;
+	size = max(size, uio_get_map_size(base));
+	fd = open(buf, O_RDWR);
+#endif
+	if (fd < 0) {
 		printf("%s: Can't open %s\n\r", __func__, buf);
 		return FAILURE;
 	}
 
-	uio_addr = mmap(NULL,
-			offset + sizeof(*read),
-			PROT_READ|PROT_WRITE,
-			MAP_SHARED,
-			uio_fd,
-			0);
-	if (uio_addr == MAP_FAILED) {
+	map_size = (delta + size + page_size - 1) & ~(page_size - 1);
+	addr = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+		    map_offset);
+	/* The mapping stays valid after the file is closed. */
+	close(fd);
+	if (addr == MAP_FAILED) {
 		printf("%s: mmap() failed\n\r", __func__);
-		status = FAILURE;
-		goto close;
+		return FAILURE;
 	}
 
-	if (read)
-		*read = *(uint32_t *)((uintptr_t)uio_addr + offset);
-	if (write)
-		*(uint32_t *)((uintptr_t)uio_addr + offset) = *write;
+	map->base = base;
+	map->map_addr = addr;
+	map->map_size = map_size;
+	map->addr = (uint8_t *)addr + delta;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the address of a register window, mapping it on first use.
+ * The window is grown if the requested range is outside it.
+ * @param base - UIO index (/dev/uioX)/base address.
+ * @param offset - Address offset.
+ * @param len - Number of bytes to be accessed.
+ * @return Address corresponding to base + offset, NULL in case of failure.
+ */
+static volatile uint32_t *axi_io_get_addr(uint32_t base, uint32_t offset,
+		size_t len)
+{
+	struct axi_io_mapping *map;
+	size_t size = (size_t)offset + len;
+	uint32_t i;
+
+	for (i = 0; i < nb_mappings; i++)
+		if (mappings[i].base == base)
+			break;
+	map = &mappings[i];
 
-	ret = munmap(uio_addr, offset + sizeof(*read));
-	if (ret < 0) {
-		printf("%s: munmap() failed\n\r", __func__);
-		status = FAILURE;
+	if (i < nb_mappings) {
+		if (size <= map->map_size -
+		    (size_t)(map->addr - (uint8_t *)map->map_addr))
+			return (volatile uint32_t *)(map->addr + offset);
+		munmap(map->map_addr, map->map_size);
+	} else if (nb_mappings == AXI_IO_MAX_MAPPINGS) {
+		return NULL;
 	}
 
-close:
-	ret = close(uio_fd);
-	if (ret < 0) {
-		printf("%s: Can't close %s\n\r", __func__, buf);
-		status = FAILURE;
+	if (axi_io_map(base, size, map)) {
+		/* Drop the entry of the old window */
+		if (i < nb_mappings)
+			mappings[i] = mappings[--nb_mappings];
+		return NULL;
 	}
+	if (i == nb_mappings)
+		nb_mappings++;
 
-	return status;
+	return (volatile uint32_t *)(map->addr + offset);
 }
 
+#ifdef DEVMEM
 /**
  * @brief AXI IO through devmem read/write function.
  * @param base - Base address.
@@ -157,6 +250,7 @@ close:
 
 	return ret;
 }
+#endif
 
 /**
  * @brief AXI IO through UIO/devmem read function.
@@ -167,11 +261,20 @@ close:
  */
 int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
 {
+	volatile uint32_t *reg;
+
+	reg = axi_io_get_addr(base, offset, sizeof(*data));
+	if (!reg) {
 #ifdef DEVMEM
-	return devmem_read_write(base, offset, data, NULL);
+		return devmem_read_write(base, offset, data, NULL);
 #else
-	return uio_read_write(base, offset, data, NULL);
+		return FAILURE;
 #endif
+	}
+
+	*data = *reg;
+
+	return SUCCESS;
 }
 
 /**
@@ -183,9 +286,66 @@ int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
  */
 int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 {
+	volatile uint32_t *reg;
+
+	reg = axi_io_get_addr(base, offset, sizeof(data));
+	if (!reg) {
 #ifdef DEVMEM
-	return devmem_read_write(base, offset, NULL, &data);
+		return devmem_read_write(base, offset, NULL, &data);
 #else
-	return uio_read_write(base, offset, NULL, &data);
+		return FAILURE;
 #endif
+	}
+
+	*reg = data;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO through UIO/devmem read of consecutive registers.
+ * @param base - UIO index (/dev/uioX)/base address.
+ * @param offset - Address offset of the first register.
+ * @param data - Location where read data will be stored.
+ * @param nb_regs - Number of registers to read.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_read_bulk(uint32_t base, uint32_t offset, uint32_t *data,
+			 uint32_t nb_regs)
+{
+	volatile uint32_t *reg;
+	uint32_t i;
+
+	reg = axi_io_get_addr(base, offset, nb_regs * sizeof(*data));
+	if (!reg)
+		return FAILURE;
+
+	for (i = 0; i < nb_regs; i++)
+		data[i] = reg[i];
+
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO through UIO/devmem write of consecutive registers.
+ * @param base - UIO index (/dev/uioX)/base address.
+ * @param offset - Address offset of the first register.
+ * @param data - Data to be written.
+ * @param nb_regs - Number of registers to write.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write_bulk(uint32_t base, uint32_t offset, const uint32_t *data,
+			  uint32_t nb_regs)
+{
+	volatile uint32_t *reg;
+	uint32_t i;
+
+	reg = axi_io_get_addr(base, offset, nb_regs * sizeof(*data));
+	if (!reg)
+		return FAILURE;
+
+	for (i = 0; i < nb_regs; i++)
+		reg[i] = data[i];
+
+	return SUCCESS;
 }
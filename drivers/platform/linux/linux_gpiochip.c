@@ -0,0 +1,746 @@
+/*******************************************************************************
+ *   @file   linux/linux_gpiochip.c
+ *   @brief  Implementation of the Linux GPIO character device driver.
+ *   @author Mihail Chindris (mihail.chindris@analog.com)
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "error.h"
+#include "gpio.h"
+#include "linux_gpiochip.h"
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Consumer label of the requested lines */
+#define LINUX_GPIOCHIP_CONSUMER		"no-OS"
+
+/** Line flags kept from the line state found at request time */
+#define LINUX_GPIOCHIP_CFG_FLAGS	(GPIO_V2_LINE_FLAG_ACTIVE_LOW | \
+					 GPIO_V2_LINE_FLAG_INPUT | \
+					 GPIO_V2_LINE_FLAG_OUTPUT | \
+					 GPIO_V2_LINE_FLAG_OPEN_DRAIN | \
+					 GPIO_V2_LINE_FLAG_OPEN_SOURCE | \
+					 GPIO_V2_LINE_FLAG_BIAS_PULL_UP | \
+					 GPIO_V2_LINE_FLAG_BIAS_PULL_DOWN | \
+					 GPIO_V2_LINE_FLAG_BIAS_DISABLED)
+
+/** Line flags only valid for outputs */
+#define LINUX_GPIOCHIP_DRIVE_FLAGS	(GPIO_V2_LINE_FLAG_OPEN_DRAIN | \
+					 GPIO_V2_LINE_FLAG_OPEN_SOURCE)
+
+/** Line flags only valid for inputs */
+#define LINUX_GPIOCHIP_EDGE_FLAGS	(GPIO_V2_LINE_FLAG_EDGE_RISING | \
+					 GPIO_V2_LINE_FLAG_EDGE_FALLING)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_gpiochip_line
+ * @brief State of a line of a line request
+ */
+struct linux_gpiochip_line {
+	/** Offset of the line in the chip */
+	uint32_t offset;
+	/** GPIO_V2_LINE_FLAG_* flags of the line */
+	uint64_t flags;
+	/** Edge read from the request but not yet returned. Only the most
+	 * recent edge is kept */
+	struct gpio_event event;
+	/** True if event holds an edge */
+	bool pending;
+};
+
+/**
+ * @struct linux_gpiochip_req
+ * @brief Lines requested together, shared by their GPIO descriptors
+ */
+struct linux_gpiochip_req {
+	/** Line request file descriptor */
+	int fd;
+	/** Number of descriptors using the request */
+	uint32_t refs;
+	/** Values of the output lines, bit i for line i of the request */
+	uint64_t out_values;
+	/** Number of lines */
+	uint32_t nb_lines;
+	/** State of each line */
+	struct linux_gpiochip_line lines[];
+};
+
+/**
+ * @struct linux_gpiochip_desc
+ * @brief Linux platform specific GPIO character device descriptor
+ */
+struct linux_gpiochip_desc {
+	/** Line request the GPIO belongs to */
+	struct linux_gpiochip_req *req;
+	/** Index of the GPIO in the line request */
+	uint32_t line;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Apply the flags and the output values of all the lines of a request.
+ * @param req - The line request.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpiochip_set_config(struct linux_gpiochip_req *req)
+{
+	struct gpio_v2_line_config_attribute *attr;
+	struct gpio_v2_line_config config;
+	uint64_t out_mask = 0;
+	uint32_t i;
+	uint32_t j;
+
+	memset(&config, 0, sizeof(config));
+	config.flags = req->lines[0].flags;
+
+	for (i = 0; i < req->nb_lines; i++) {
+		if (req->lines[i].flags & GPIO_V2_LINE_FLAG_OUTPUT)
+			out_mask |= 1ULL << i;
+		if (req->lines[i].flags == config.flags)
+			continue;
+
+		for (j = 0; j < config.num_attrs; j++)
+			if (config.attrs[j].attr.flags == req->lines[i].flags)
+				break;
+		if (j == config.num_attrs) {
+			/* Keep the last attribute for the output values */
+			if (j == GPIO_V2_LINE_NUM_ATTRS_MAX - 1)
+				return -EINVAL;
+			config.attrs[j].attr.id = GPIO_V2_LINE_ATTR_ID_FLAGS;
+			config.attrs[j].attr.flags = req->lines[i].flags;
+			config.num_attrs++;
+		}
+		config.attrs[j].mask |= 1ULL << i;
+	}
+
+	if (out_mask) {
+		attr = &config.attrs[config.num_attrs++];
+		attr->attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+		attr->attr.values = req->out_values;
+		attr->mask = out_mask;
+	}
+
+	if (ioctl(req->fd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) < 0)
+		return -errno;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Change the flags of a line.
+ * @param desc - The GPIO descriptor.
+ * @param flags - The new GPIO_V2_LINE_FLAG_* flags of the line.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpiochip_set_flags(struct gpio_desc *desc,
+					uint64_t flags)
+{
+	struct linux_gpiochip_desc *linux_desc = desc->extra;
+	struct linux_gpiochip_line *line;
+	uint64_t old_flags;
+	int32_t ret;
+
+	line = &linux_desc->req->lines[linux_desc->line];
+	old_flags = line->flags;
+	line->flags = flags;
+
+	ret = linux_gpiochip_set_config(linux_desc->req);
+	if (ret) {
+		printf("%s: Can't configure line %"PRIu32"\n\r", __func__,
+		       line->offset);
+		line->flags = old_flags;
+	}
+
+	return ret;
+}
+
+/**
+ * @brief Obtain the descriptors of several GPIOs of the same chip. The lines
+ * are requested together, so they can be accessed with a single ioctl.
+ * @param descs - Array where the GPIO descriptors are stored.
+ * @param params - Array of GPIO initialization parameters.
+ * @param nb_gpios - Number of GPIOs.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_gpiochip_get_bulk(struct gpio_desc **descs,
+				const struct gpio_init_param *params,
+				uint32_t nb_gpios)
+{
+	struct linux_gpiochip_init_param *linux_init;
+	struct linux_gpiochip_desc *linux_desc;
+	struct gpio_v2_line_request request;
+	struct gpio_v2_line_values values;
+	struct gpio_v2_line_info info;
+	struct linux_gpiochip_req *req;
+	uint32_t chip_id;
+	char path[64];
+	int chip_fd;
+	uint32_t i;
+	int32_t ret;
+
+	if (nb_gpios > GPIO_V2_LINES_MAX)
+		return -EINVAL;
+
+	chip_id = 0;
+	for (i = 0; i < nb_gpios; i++) {
+		linux_init = params[i].extra;
+		if (linux_init && i == 0)
+			chip_id = linux_init->chip_id;
+		if ((linux_init ? linux_init->chip_id : 0) != chip_id)
+			return -EINVAL;
+	}
+
+	req = calloc(1, sizeof(*req) + nb_gpios * sizeof(req->lines[0]));
+	if (!req)
+		return -ENOMEM;
+	req->nb_lines = nb_gpios;
+
+	snprintf(path, sizeof(path), "/dev/gpiochip%"PRIu32, chip_id);
+	chip_fd = open(path, O_RDWR | O_CLOEXEC);
+	if (chip_fd < 0) {
+		printf("%s: Can't open %s\n\r", __func__, path);
+		ret = -errno;
+		goto free_req;
+	}
+
+	/* Request the lines as they are, then read back their configuration */
+	memset(&request, 0, sizeof(request));
+	for (i = 0; i < nb_gpios; i++) {
+		request.offsets[i] = params[i].number;
+		req->lines[i].offset = params[i].number;
+	}
+	strncpy(request.consumer, LINUX_GPIOCHIP_CONSUMER,
+		sizeof(request.consumer) - 1);
+	request.num_lines = nb_gpios;
+
+	if (ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &request) < 0) {
+		printf("%s: Can't request lines of %s\n\r", __func__, path);
+		ret = -errno;
+		goto close_chip;
+	}
+	req->fd = request.fd;
+
+	for (i = 0; i < nb_gpios; i++) {
+		memset(&info, 0, sizeof(info));
+		info.offset = req->lines[i].offset;
+		if (ioctl(chip_fd, GPIO_V2_GET_LINEINFO_IOCTL, &info) < 0) {
+			ret = -errno;
+			goto close_req;
+		}
+		req->lines[i].flags = info.flags & LINUX_GPIOCHIP_CFG_FLAGS;
+	}
+
+	values.mask = (nb_gpios == GPIO_V2_LINES_MAX) ? UINT64_MAX :
+		      (1ULL << nb_gpios) - 1;
+	if (ioctl(req->fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) < 0) {
+		ret = -errno;
+		goto close_req;
+	}
+	req->out_values = values.bits;
+
+	for (i = 0; i < nb_gpios; i++) {
+		descs[i] = calloc(1, sizeof(*descs[i]));
+		if (!descs[i])
+			goto free_descs;
+
+		linux_desc = calloc(1, sizeof(*linux_desc));
+		if (!linux_desc) {
+			free(descs[i]);
+			goto free_descs;
+		}
+		linux_desc->req = req;
+		linux_desc->line = i;
+
+		descs[i]->number = params[i].number;
+		descs[i]->extra = linux_desc;
+	}
+	req->refs = nb_gpios;
+
+	close(chip_fd);
+
+	return SUCCESS;
+
+free_descs:
+	ret = -ENOMEM;
+	while (i--) {
+		free(descs[i]->extra);
+		free(descs[i]);
+	}
+close_req:
+	close(req->fd);
+close_chip:
+	close(chip_fd);
+free_req:
+	free(req);
+
+	return ret;
+}
+
+/**
+ * @brief Obtain the GPIO decriptor.
+ * @param desc - The GPIO descriptor.
+ * @param param - GPIO initialization parameters
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_gpiochip_get(struct gpio_desc **desc,
+			   const struct gpio_init_param *param)
+{
+	return linux_gpiochip_get_bulk(desc, param, 1);
+}
+
+/**
+ * @brief Obtain optional GPIO descriptor.
+ * @param desc - The GPIO descriptor.
+ * @param param - GPIO Initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_gpiochip_get_optional(struct gpio_desc **desc,
+				    const struct gpio_init_param *param)
+{
+	return linux_gpiochip_get_bulk(desc, param, 1);
+}
+
+/**
+ * @brief Free the resources allocated by gpio_get(). The line request is
+ * released together with its last descriptor.
+ * @param desc - The GPIO descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_gpiochip_remove(struct gpio_desc *desc)
+{
+	struct linux_gpiochip_desc *linux_desc;
+	struct linux_gpiochip_req *req;
+
+	linux_desc = desc->extra;
+	req = linux_desc->req;
+
+	if (--req->refs == 0) {
+		close(req->fd);
+		free(req);
+	}
+
+	free(desc->extra);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the values of several GPIOs. The GPIOs that belong to the same
+ * line request are set with a single ioctl.
+ * @param descs - Array of GPIO descriptors.
+ * @param nb_gpios - Number of GPIOs.
+ * @param values - Array with the value of each GPIO.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_gpiochip_set_values(struct gpio_desc **descs,
+				  uint32_t nb_gpios,
+				  const uint8_t *values)
+{
+	struct linux_gpiochip_desc *linux_desc;
+	struct gpio_v2_line_values lv;
+	struct linux_gpiochip_req *req;
+	uint32_t i;
+	uint32_t j;
+
+	for (i = 0; i < nb_gpios; i++) {
+		req = ((struct linux_gpiochip_desc *)descs[i]->extra)->req;
+		for (j = 0; j < i; j++)
+			if (((struct linux_gpiochip_desc *)descs[j]->extra)->req == req)
+				break;
+		if (j < i)
+			continue;
+
+		lv.mask = 0;
+		lv.bits = 0;
+		for (j = i; j < nb_gpios; j++) {
+			linux_desc = descs[j]->extra;
+			if (linux_desc->req != req)
+				continue;
+			lv.mask |= 1ULL << linux_desc->line;
+			if (values[j])
+				lv.bits |= 1ULL << linux_desc->line;
+		}
+
+		if (ioctl(req->fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &lv) < 0) {
+			printf("%s: Can't set values\n\r", __func__);
+			return -errno;
+		}
+		req->out_values = (req->out_values & ~lv.mask) | lv.bits;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the values of several GPIOs. The GPIOs that belong to the same
+ * line request are read with a single ioctl.
+ * @param descs - Array of GPIO descriptors.
+ * @param nb_gpios - Number of GPIOs.
+ * @param values - Array where the value of each GPIO is stored.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_gpiochip_get_values(struct gpio_desc **descs,
+				  uint32_t nb_gpios,
+				  uint8_t *values)
+{
+	struct linux_gpiochip_desc *linux_desc;
+	struct gpio_v2_line_values lv;
+	struct linux_gpiochip_req *req;
+	uint32_t i;
+	uint32_t j;
+
+	for (i = 0; i < nb_gpios; i++) {
+		req = ((struct linux_gpiochip_desc *)descs[i]->extra)->req;
+		for (j = 0; j < i; j++)
+			if (((struct linux_gpiochip_desc *)descs[j]->extra)->req == req)
+				break;
+		if (j < i)
+			continue;
+
+		lv.mask = 0;
+		lv.bits = 0;
+		for (j = i; j < nb_gpios; j++) {
+			linux_desc = descs[j]->extra;
+			if (linux_desc->req == req)
+				lv.mask |= 1ULL << linux_desc->line;
+		}
+
+		if (ioctl(req->fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &lv) < 0) {
+			printf("%s: Can't get values\n\r", __func__);
+			return -errno;
+		}
+
+		for (j = i; j < nb_gpios; j++) {
+			linux_desc = descs[j]->extra;
+			if (linux_desc->req == req)
+				values[j] = (lv.bits >> linux_desc->line) & 1 ?
+					    GPIO_HIGH : GPIO_LOW;
+		}
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the value of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ *                Example: GPIO_HIGH
+ *                         GPIO_LOW
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_gpiochip_set_value(struct gpio_desc *desc,
+				 uint8_t value)
+{
+	return linux_gpiochip_set_values(&desc, 1, &value);
+}
+
+/**
+ * @brief Get the value of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ *                Example: GPIO_HIGH
+ *                         GPIO_LOW
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_gpiochip_get_value(struct gpio_desc *desc,
+				 uint8_t *value)
+{
+	return linux_gpiochip_get_values(&desc, 1, value);
+}
+
+/**
+ * @brief Enable the input direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_gpiochip_direction_input(struct gpio_desc *desc)
+{
+	struct linux_gpiochip_desc *linux_desc = desc->extra;
+	uint64_t flags;
+
+	flags = linux_desc->req->lines[linux_desc->line].flags;
+	flags &= ~(GPIO_V2_LINE_FLAG_OUTPUT | LINUX_GPIOCHIP_DRIVE_FLAGS);
+	flags |= GPIO_V2_LINE_FLAG_INPUT;
+
+	return linux_gpiochip_set_flags(desc, flags);
+}
+
+/**
+ * @brief Enable the output direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ *                Example: GPIO_HIGH
+ *                         GPIO_LOW
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_gpiochip_direction_output(struct gpio_desc *desc,
+					uint8_t value)
+{
+	struct linux_gpiochip_desc *linux_desc = desc->extra;
+	struct linux_gpiochip_req *req = linux_desc->req;
+	uint64_t old_values;
+	uint64_t flags;
+	int32_t ret;
+
+	old_values = req->out_values;
+	if (value)
+		req->out_values |= 1ULL << linux_desc->line;
+	else
+		req->out_values &= ~(1ULL << linux_desc->line);
+
+	flags = req->lines[linux_desc->line].flags;
+	flags &= ~(GPIO_V2_LINE_FLAG_INPUT | LINUX_GPIOCHIP_EDGE_FLAGS);
+	flags |= GPIO_V2_LINE_FLAG_OUTPUT;
+
+	ret = linux_gpiochip_set_flags(desc, flags);
+	if (ret)
+		req->out_values = old_values;
+
+	return ret;
+}
+
+/**
+ * @brief Get the direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param direction - The direction.
+ *                    Example: GPIO_OUT
+ *                             GPIO_IN
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_gpiochip_get_direction(struct gpio_desc *desc,
+				     uint8_t *direction)
+{
+	struct linux_gpiochip_desc *linux_desc = desc->extra;
+
+	if (linux_desc->req->lines[linux_desc->line].flags &
+	    GPIO_V2_LINE_FLAG_OUTPUT)
+		*direction = GPIO_OUT;
+	else
+		*direction = GPIO_IN;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read one edge from a line request and store it in the state of its
+ * line.
+ * @param req - The line request.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpiochip_read_event(struct linux_gpiochip_req *req)
+{
+	struct gpio_v2_line_event ev;
+	struct linux_gpiochip_line *line;
+	ssize_t ret;
+	uint32_t i;
+
+	ret = read(req->fd, &ev, sizeof(ev));
+	if (ret < 0)
+		return -errno;
+	if (ret != sizeof(ev))
+		return -EIO;
+
+	for (i = 0; i < req->nb_lines; i++) {
+		line = &req->lines[i];
+		if (line->offset != ev.offset)
+			continue;
+
+		line->event.edge = (ev.id == GPIO_V2_LINE_EVENT_RISING_EDGE) ?
+				   GPIO_EDGE_RISING : GPIO_EDGE_FALLING;
+		line->event.timestamp_ns = ev.timestamp_ns;
+		line->pending = true;
+		break;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Wait for an edge on the specified GPIO.
+ *
+ * Edges are read one at a time from the line request, so the edges of the
+ * GPIO are returned in order. For a GPIO that shares its line request with
+ * others, only the most recent edge of the other GPIOs is kept until they
+ * are waited for.
+ * @param desc - The GPIO descriptor.
+ * @param edge - The edge to wait for. Other edges are discarded.
+ * @param timeout_us - Timeout in microseconds.
+ * @param event - Where the detected edge is stored. May be NULL.
+ * @return SUCCESS in case of success, -ETIMEDOUT if no edge was detected in
+ * time, other negative error code otherwise.
+ */
+int32_t linux_gpiochip_wait_edge(struct gpio_desc *desc,
+				 enum gpio_edge edge,
+				 uint32_t timeout_us,
+				 struct gpio_event *event)
+{
+	struct linux_gpiochip_desc *linux_desc = desc->extra;
+	struct linux_gpiochip_line *line;
+	struct timespec now, end;
+	struct pollfd pfd;
+	uint64_t flags;
+	int64_t left_us;
+	int32_t ret;
+
+	switch (edge) {
+	case GPIO_EDGE_RISING:
+		flags = GPIO_V2_LINE_FLAG_EDGE_RISING;
+		break;
+	case GPIO_EDGE_FALLING:
+		flags = GPIO_V2_LINE_FLAG_EDGE_FALLING;
+		break;
+	case GPIO_EDGE_BOTH:
+		flags = LINUX_GPIOCHIP_EDGE_FLAGS;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	line = &linux_desc->req->lines[linux_desc->line];
+	if ((line->flags & flags) != flags) {
+		if (line->flags & GPIO_V2_LINE_FLAG_OUTPUT)
+			return -EINVAL;
+		ret = linux_gpiochip_set_flags(desc, line->flags | flags |
+					       GPIO_V2_LINE_FLAG_INPUT);
+		if (ret)
+			return ret;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	end.tv_sec += timeout_us / 1000000;
+	end.tv_nsec += (timeout_us % 1000000) * 1000;
+	if (end.tv_nsec >= 1000000000) {
+		end.tv_sec++;
+		end.tv_nsec -= 1000000000;
+	}
+
+	pfd.fd = linux_desc->req->fd;
+	pfd.events = POLLIN;
+
+	while (true) {
+		if (line->pending) {
+			line->pending = false;
+			if (edge == GPIO_EDGE_BOTH || line->event.edge == edge) {
+				if (event)
+					*event = line->event;
+				return SUCCESS;
+			}
+			continue;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		left_us = (end.tv_sec - now.tv_sec) * 1000000 +
+			  (end.tv_nsec - now.tv_nsec) / 1000;
+		if (left_us < 0)
+			left_us = 0;
+
+		ret = poll(&pfd, 1, (left_us + 999) / 1000);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			return -errno;
+		}
+		if (ret == 0)
+			return -ETIMEDOUT;
+
+		ret = linux_gpiochip_read_event(linux_desc->req);
+		if (ret)
+			return ret;
+	}
+}
+
+/**
+ * @brief Get the file descriptor on which the edges of a GPIO are reported.
+ * The descriptor can be polled together with other file descriptors, then
+ * the edge is retrieved with gpio_wait_edge() and a timeout of 0.
+ * @param desc - The GPIO descriptor.
+ * @return The file descriptor, or negative error code.
+ */
+int linux_gpiochip_get_event_fd(struct gpio_desc *desc)
+{
+	struct linux_gpiochip_desc *linux_desc;
+
+	if (!desc)
+		return -EINVAL;
+
+	linux_desc = desc->extra;
+
+	return linux_desc->req->fd;
+}
+
+/**
+ * @brief Linux platform specific GPIO character device platform ops structure
+ */
+const struct gpio_platform_ops linux_gpiochip_platform_ops = {
+	.gpio_ops_get = &linux_gpiochip_get,
+	.gpio_ops_get_optional = &linux_gpiochip_get_optional,
+	.gpio_ops_remove = &linux_gpiochip_remove,
+	.gpio_ops_direction_input = &linux_gpiochip_direction_input,
+	.gpio_ops_direction_output = &linux_gpiochip_direction_output,
+	.gpio_ops_get_direction = &linux_gpiochip_get_direction,
+	.gpio_ops_set_value = &linux_gpiochip_set_value,
+	.gpio_ops_get_value = &linux_gpiochip_get_value,
+	.gpio_ops_get_bulk = &linux_gpiochip_get_bulk,
+	.gpio_ops_set_values = &linux_gpiochip_set_values,
+	.gpio_ops_get_values = &linux_gpiochip_get_values,
+	.gpio_ops_wait_edge = &linux_gpiochip_wait_edge,
+};
@@ -50,6 +50,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 
 /******************************************************************************/
@@ -63,6 +64,8 @@
 struct linux_i2c_desc {
 	/** /dev/i2c-"device_id" file descriptor */
 	int fd;
+	/** Slave address last selected with I2C_SLAVE, -1 if none */
+	int slave_address;
 };
 
 /******************************************************************************/
@@ -101,6 +104,7 @@ int32_t linux_i2c_init(struct i2c_desc **desc,
 		printf("%s: Can't open %s\n\r", __func__, path);
 		goto free;
 	}
+	linux_desc->slave_address = -1;
 
 	descriptor->slave_address = param->slave_address;
 
@@ -116,6 +120,32 @@ free_desc:
 	return FAILURE;
 }
 
+/**
+ * @brief Select the slave device of the descriptor for read() and write().
+ * The ioctl is only issued when the slave address changes.
+ * @param desc - The I2C descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_i2c_select(struct i2c_desc *desc)
+{
+	struct linux_i2c_desc *linux_desc;
+	int32_t ret;
+
+	linux_desc = desc->extra;
+	if (linux_desc->slave_address == desc->slave_address)
+		return SUCCESS;
+
+	ret = ioctl(linux_desc->fd, I2C_SLAVE, desc->slave_address);
+	if (ret < 0) {
+		printf("%s: Can't select device\n\r", __func__);
+		linux_desc->slave_address = -1;
+		return FAILURE;
+	}
+	linux_desc->slave_address = desc->slave_address;
+
+	return SUCCESS;
+}
+
 /**
  * @brief Free the resources allocated by i2c_init().
  * @param desc - The I2C descriptor.
@@ -160,11 +190,9 @@ int32_t linux_i2c_write(struct i2c_desc *desc,
 
 	linux_desc = desc->extra;
 
-	ret = ioctl(linux_desc->fd, I2C_SLAVE, desc->slave_address);
-	if (ret < 0) {
-		printf("%s: Can't select device\n\r", __func__);
+	ret = linux_i2c_select(desc);
+	if (ret < 0)
 		return FAILURE;
-	}
 
 	ret = write(linux_desc->fd, data, bytes_number);
 	if (ret < 0) {
@@ -199,11 +227,9 @@ int32_t linux_i2c_read(struct i2c_desc *desc,
 
 	linux_desc = desc->extra;
 
-	ret = ioctl(linux_desc->fd, I2C_SLAVE, desc->slave_address);
-	if (ret < 0) {
-		printf("%s: Can't select device\n\r", __func__);
+	ret = linux_i2c_select(desc);
+	if (ret < 0)
 		return FAILURE;
-	}
 
 	ret = read(linux_desc->fd, data, bytes_number);
 	if (ret < 0) {
@@ -218,6 +244,58 @@ int32_t linux_i2c_read(struct i2c_desc *desc,
 	return SUCCESS;
 }
 
+/**
+ * @brief Issue several messages to a slave device as one transaction.
+ *
+ * Each run of messages up to a stop condition is handed to the kernel with a
+ * single I2C_RDWR ioctl, so the messages of a run are separated by repeated
+ * starts.
+ * @param desc - The I2C descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_i2c_transfer(struct i2c_desc *desc,
+			   struct i2c_transfer_msg *msgs,
+			   uint32_t len)
+{
+	struct i2c_msg xfer[I2C_RDWR_IOCTL_MAX_MSGS];
+	struct i2c_rdwr_ioctl_data data;
+	struct linux_i2c_desc *linux_desc;
+	uint32_t n;
+	int32_t ret;
+
+	linux_desc = desc->extra;
+	data.msgs = xfer;
+
+	while (len) {
+		for (n = 0; n < len; n++) {
+			if (n == I2C_RDWR_IOCTL_MAX_MSGS)
+				return -EINVAL;
+			xfer[n].addr = desc->slave_address;
+			xfer[n].flags = (msgs[n].flags & I2C_MSG_RD) ? I2C_M_RD : 0;
+			xfer[n].len = msgs[n].bytes_number;
+			xfer[n].buf = msgs[n].buff;
+			if (msgs[n].flags & I2C_MSG_STOP) {
+				n++;
+				break;
+			}
+		}
+
+		data.nmsgs = n;
+		ret = ioctl(linux_desc->fd, I2C_RDWR, &data);
+		if (ret < 0) {
+			printf("%s: Can't transfer messages\n\r", __func__);
+			return -errno;
+		}
+
+		msgs += n;
+		len -= n;
+	}
+
+	return SUCCESS;
+}
+
 /**
  * @brief Linux platform specific I2C platform ops structure
  */
@@ -225,5 +303,6 @@ const struct i2c_platform_ops linux_i2c_platform_ops = {
 	.i2c_ops_init = &linux_i2c_init,
 	.i2c_ops_write = &linux_i2c_write,
 	.i2c_ops_read = &linux_i2c_read,
+	.i2c_ops_transfer = &linux_i2c_transfer,
 	.i2c_ops_remove = &linux_i2c_remove
 };
@@ -0,0 +1,516 @@
+/***************************************************************************//**
+ *   @file   linux/linux_socket.c
+ *   @brief  Implementation of the Linux platform network interface.
+ *   @author Mihail Chindris (mihail.chindris@analog.com)
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "error.h"
+#include "linux_socket.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_socket_desc
+ * @brief Linux platform network interface descriptor. The socket ids are the
+ * file descriptors of the sockets.
+ */
+struct linux_socket_desc {
+	/** Network interface handed out to the socket layer */
+	struct network_interface	interface;
+	/** poll() file descriptors, reused between calls */
+	struct pollfd			*pfds;
+	/** Number of elements allocated in pfds */
+	uint32_t			pfds_size;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Wait until a socket is ready for a single operation.
+ * @param fd - Socket file descriptor.
+ * @param events - poll() events to wait for.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t linux_socket_wait(int fd, short events)
+{
+	struct pollfd	pfd = {
+		.fd = fd,
+		.events = events,
+	};
+	int		ret;
+
+	do {
+		ret = poll(&pfd, 1, -1);
+	} while (ret < 0 && errno == EINTR);
+
+	return ret < 0 ? -errno : SUCCESS;
+}
+
+/**
+ * @brief Fill a socket address from an address string and a port.
+ * @param addr - Remote host, as a name or an IPv4 address.
+ * @param port - Port.
+ * @param sin - Socket address to be filled.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t linux_socket_resolve(const char *addr, uint16_t port,
+				    struct sockaddr_in *sin)
+{
+	struct addrinfo	hints = {
+		.ai_family = AF_INET,
+	};
+	struct addrinfo	*res;
+
+	memset(sin, 0, sizeof(*sin));
+	sin->sin_family = AF_INET;
+	sin->sin_port = htons(port);
+
+	if (inet_pton(AF_INET, addr, &sin->sin_addr) == 1)
+		return SUCCESS;
+
+	if (getaddrinfo(addr, NULL, &hints, &res))
+		return -EINVAL;
+
+	sin->sin_addr = ((struct sockaddr_in *)res->ai_addr)->sin_addr;
+	freeaddrinfo(res);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Make a socket non blocking.
+ * @param fd - Socket file descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t linux_socket_set_nonblock(int fd)
+{
+	int flags;
+
+	flags = fcntl(fd, F_GETFL);
+	if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+		return -errno;
+
+	return SUCCESS;
+}
+
+/** @brief See \ref network_interface.socket_open */
+static int32_t linux_socket_open(struct linux_socket_desc *desc,
+				 uint32_t *sock_id,
+				 enum socket_protocol proto,
+				 uint32_t buff_size)
+{
+	int	fd;
+	int	size = buff_size;
+	int32_t	ret;
+
+	fd = socket(AF_INET, proto == PROTOCOL_TCP ? SOCK_STREAM : SOCK_DGRAM,
+		    0);
+	if (fd < 0)
+		return -errno;
+
+	ret = linux_socket_set_nonblock(fd);
+	if (IS_ERR_VALUE(ret)) {
+		close(fd);
+		return ret;
+	}
+
+	/* The size is only a hint for the kernel */
+	setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+	*sock_id = fd;
+
+	return SUCCESS;
+}
+
+/** @brief See \ref network_interface.socket_close */
+static int32_t linux_socket_close(struct linux_socket_desc *desc,
+				  uint32_t sock_id)
+{
+	if (close(sock_id) < 0)
+		return -errno;
+
+	return SUCCESS;
+}
+
+/** @brief See \ref network_interface.socket_connect */
+static int32_t linux_socket_connect(struct linux_socket_desc *desc,
+				    uint32_t sock_id,
+				    struct socket_address *addr)
+{
+	struct sockaddr_in	sin;
+	socklen_t		len;
+	int			err;
+	int32_t			ret;
+
+	if (!addr || !addr->addr)
+		return -EINVAL;
+
+	ret = linux_socket_resolve(addr->addr, addr->port, &sin);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	if (!connect(sock_id, (struct sockaddr *)&sin, sizeof(sin)))
+		return SUCCESS;
+	if (errno != EINPROGRESS)
+		return -errno;
+
+	ret = linux_socket_wait(sock_id, POLLOUT);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	len = sizeof(err);
+	if (getsockopt(sock_id, SOL_SOCKET, SO_ERROR, &err, &len) < 0)
+		return -errno;
+
+	return -err;
+}
+
+/** @brief See \ref network_interface.socket_disconnect */
+static int32_t linux_socket_disconnect(struct linux_socket_desc *desc,
+				       uint32_t sock_id)
+{
+	if (shutdown(sock_id, SHUT_RDWR) < 0)
+		return -errno;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief See \ref network_interface.socket_send
+ *
+ * Waits until all the data is queued in the socket.
+ */
+static int32_t linux_socket_send(struct linux_socket_desc *desc,
+				 uint32_t sock_id,
+				 const void *data, uint32_t size)
+{
+	uint32_t	sent = 0;
+	ssize_t		ret;
+
+	while (sent < size) {
+		ret = send(sock_id, (const uint8_t *)data + sent, size - sent,
+			   MSG_NOSIGNAL);
+		if (ret >= 0) {
+			sent += ret;
+			continue;
+		}
+		if (errno == EPIPE || errno == ECONNRESET)
+			return -ENOTCONN;
+		if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+			return -errno;
+
+		ret = linux_socket_wait(sock_id, POLLOUT);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return sent;
+}
+
+/** @brief See \ref network_interface.socket_recv */
+static int32_t linux_socket_recv(struct linux_socket_desc *desc,
+				 uint32_t sock_id,
+				 void *data, uint32_t size)
+{
+	ssize_t ret;
+
+	ret = recv(sock_id, data, size, 0);
+	if (ret > 0)
+		return ret;
+	/* Orderly shutdown of the remote host */
+	if (ret == 0 && size)
+		return -ENOTCONN;
+	if (ret == 0)
+		return 0;
+	if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+		return -EAGAIN;
+
+	/* Any other error means the connection is lost */
+	return -ENOTCONN;
+}
+
+/** @brief See \ref network_interface.socket_sendto */
+static int32_t linux_socket_sendto(struct linux_socket_desc *desc,
+				   uint32_t sock_id,
+				   const void *data, uint32_t size,
+				   const struct socket_address *to)
+{
+	struct sockaddr_in	sin;
+	ssize_t			ret;
+
+	if (!to || !to->addr)
+		return -EINVAL;
+
+	ret = linux_socket_resolve(to->addr, to->port, &sin);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	ret = sendto(sock_id, data, size, MSG_NOSIGNAL,
+		     (struct sockaddr *)&sin, sizeof(sin));
+	if (ret < 0)
+		return errno == EWOULDBLOCK ? -EAGAIN : -errno;
+
+	return ret;
+}
+
+/**
+ * @brief See \ref network_interface.socket_recvfrom
+ *
+ * The address string of from->addr must be able to hold INET_ADDRSTRLEN
+ * characters.
+ */
+static int32_t linux_socket_recvfrom(struct linux_socket_desc *desc,
+				     uint32_t sock_id,
+				     void *data, uint32_t size,
+				     struct socket_address *from)
+{
+	struct sockaddr_in	sin;
+	socklen_t		len = sizeof(sin);
+	ssize_t			ret;
+
+	ret = recvfrom(sock_id, data, size, 0, (struct sockaddr *)&sin, &len);
+	if (ret < 0)
+		return errno == EWOULDBLOCK ? -EAGAIN : -errno;
+
+	if (from) {
+		from->port = ntohs(sin.sin_port);
+		if (from->addr)
+			inet_ntop(AF_INET, &sin.sin_addr, from->addr,
+				  INET_ADDRSTRLEN);
+	}
+
+	return ret;
+}
+
+/** @brief See \ref network_interface.socket_bind */
+static int32_t linux_socket_bind(struct linux_socket_desc *desc,
+				 uint32_t sock_id, uint16_t port)
+{
+	struct sockaddr_in	sin;
+	int			reuse = 1;
+
+	memset(&sin, 0, sizeof(sin));
+	sin.sin_family = AF_INET;
+	sin.sin_addr.s_addr = htonl(INADDR_ANY);
+	sin.sin_port = htons(port);
+
+	/* Allow restarting the server while old connections time out */
+	setsockopt(sock_id, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	if (bind(sock_id, (struct sockaddr *)&sin, sizeof(sin)) < 0)
+		return -errno;
+
+	return SUCCESS;
+}
+
+/** @brief See \ref network_interface.socket_listen */
+static int32_t linux_socket_listen(struct linux_socket_desc *desc,
+				   uint32_t sock_id, uint32_t back_log)
+{
+	if (listen(sock_id, back_log ? (int)back_log : SOMAXCONN) < 0)
+		return -errno;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief See \ref network_interface.socket_accept
+ *
+ * Returns -EAGAIN if no connection is pending.
+ */
+static int32_t linux_socket_accept(struct linux_socket_desc *desc,
+				   uint32_t sock_id,
+				   uint32_t *client_socket_id)
+{
+	int	fd;
+	int32_t	ret;
+
+	fd = accept(sock_id, NULL, NULL);
+	if (fd < 0)
+		return (errno == EAGAIN || errno == EWOULDBLOCK) ? -EAGAIN :
+		       -errno;
+
+	ret = linux_socket_set_nonblock(fd);
+	if (IS_ERR_VALUE(ret)) {
+		close(fd);
+		return ret;
+	}
+
+	*client_socket_id = fd;
+
+	return SUCCESS;
+}
+
+/** @brief See \ref network_interface.socket_poll */
+static int32_t linux_socket_poll(struct linux_socket_desc *desc,
+				 struct socket_poll_entry *entries,
+				 uint32_t nb_entries, int32_t timeout_ms)
+{
+	struct pollfd	*pfds;
+	uint32_t	i;
+	int		ret;
+
+	if (nb_entries > desc->pfds_size) {
+		pfds = realloc(desc->pfds, nb_entries * sizeof(*pfds));
+		if (!pfds)
+			return -ENOMEM;
+		desc->pfds = pfds;
+		desc->pfds_size = nb_entries;
+	}
+
+	for (i = 0; i < nb_entries; i++) {
+		desc->pfds[i].fd = entries[i].sock_id;
+		desc->pfds[i].events = POLLIN;
+		desc->pfds[i].revents = 0;
+	}
+
+	do {
+		ret = poll(desc->pfds, nb_entries, timeout_ms);
+	} while (ret < 0 && errno == EINTR);
+	if (ret < 0)
+		return -errno;
+
+	for (i = 0; i < nb_entries; i++) {
+		entries[i].revents = 0;
+		if (desc->pfds[i].revents & POLLIN)
+			entries[i].revents |= SOCKET_POLL_IN;
+		if (desc->pfds[i].revents & (POLLHUP | POLLERR | POLLNVAL))
+			entries[i].revents |= SOCKET_POLL_HUP;
+	}
+
+	return ret;
+}
+
+/**
+ * @brief Create a network interface over the Linux BSD sockets.
+ * @param net - Address where to store the network interface.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_socket_init(struct network_interface **net)
+{
+	struct linux_socket_desc *desc;
+
+	if (!net)
+		return -EINVAL;
+
+	desc = calloc(1, sizeof(*desc));
+	if (!desc)
+		return -ENOMEM;
+
+	desc->interface.net = desc;
+	desc->interface.socket_open =
+		(int32_t (*)(void *, uint32_t *, enum socket_protocol,
+			     uint32_t))
+		linux_socket_open;
+	desc->interface.socket_close =
+		(int32_t (*)(void *, uint32_t))
+		linux_socket_close;
+	desc->interface.socket_connect =
+		(int32_t (*)(void *, uint32_t, struct socket_address *))
+		linux_socket_connect;
+	desc->interface.socket_disconnect =
+		(int32_t (*)(void *, uint32_t))
+		linux_socket_disconnect;
+	desc->interface.socket_send =
+		(int32_t (*)(void *, uint32_t, const void *, uint32_t))
+		linux_socket_send;
+	desc->interface.socket_recv =
+		(int32_t (*)(void *, uint32_t, void *, uint32_t))
+		linux_socket_recv;
+	desc->interface.socket_sendto =
+		(int32_t (*)(void *, uint32_t, const void *, uint32_t,
+			     const struct socket_address *))
+		linux_socket_sendto;
+	desc->interface.socket_recvfrom =
+		(int32_t (*)(void *, uint32_t, void *, uint32_t,
+			     struct socket_address *))
+		linux_socket_recvfrom;
+	desc->interface.socket_bind =
+		(int32_t (*)(void *, uint32_t, uint16_t))
+		linux_socket_bind;
+	desc->interface.socket_listen =
+		(int32_t (*)(void *, uint32_t, uint32_t))
+		linux_socket_listen;
+	desc->interface.socket_accept =
+		(int32_t (*)(void *, uint32_t, uint32_t*))
+		linux_socket_accept;
+	desc->interface.socket_poll =
+		(int32_t (*)(void *, struct socket_poll_entry *, uint32_t,
+			     int32_t))
+		linux_socket_poll;
+
+	*net = &desc->interface;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by linux_socket_init().
+ * @param net - Network interface.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_socket_remove(struct network_interface *net)
+{
+	struct linux_socket_desc *desc;
+
+	if (!net)
+		return -EINVAL;
+
+	desc = net->net;
+	free(desc->pfds);
+	free(desc);
+
+	return SUCCESS;
+}
@@ -46,6 +46,7 @@
 #include "linux_spi.h"
 
 #include <fcntl.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/ioctl.h>
@@ -167,6 +168,58 @@ int32_t linux_spi_write_and_read(struct spi_desc *desc,
 	return SUCCESS;
 }
 
+/**
+ * @brief Transfer a message made of multiple segments with a single ioctl.
+ * @param desc - The SPI descriptor.
+ * @param msgs - Array of message segments.
+ * @param len - Number of segments.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_spi_transfer(struct spi_desc *desc,
+			   struct spi_msg *msgs,
+			   uint32_t len)
+{
+	struct linux_spi_desc *linux_desc;
+	struct spi_ioc_transfer *tr;
+	uint32_t i;
+	int ret;
+
+	linux_desc = desc->extra;
+
+	/* The message size has to fit in the ioctl size field */
+	if (len >= (1 << _IOC_SIZEBITS) / sizeof(*tr))
+		return -EINVAL;
+
+	tr = calloc(len, sizeof(*tr));
+	if (!tr)
+		return -ENOMEM;
+
+	for (i = 0; i < len; i++) {
+		if (msgs[i].delay_us > UINT16_MAX) {
+			ret = -EINVAL;
+			goto free;
+		}
+		tr[i].tx_buf = (unsigned long)msgs[i].tx_buff;
+		tr[i].rx_buf = (unsigned long)msgs[i].rx_buff;
+		tr[i].len = msgs[i].bytes_number;
+		tr[i].delay_usecs = msgs[i].delay_us;
+		tr[i].cs_change = msgs[i].cs_change;
+	}
+
+	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_MESSAGE(len), tr);
+	if (ret < 0) {
+		printf("%s: Can't send spi message\n\r", __func__);
+		ret = -errno;
+		goto free;
+	}
+
+	ret = SUCCESS;
+free:
+	free(tr);
+
+	return ret;
+}
+
 /**
  * @brief Free the resources allocated by linux_spi_init().
  * @param desc - The SPI descriptor.
@@ -197,5 +250,6 @@ int32_t linux_spi_remove(struct spi_desc *desc)
 const struct spi_platform_ops linux_spi_platform_ops = {
 	.spi_ops_init = &linux_spi_init,
 	.spi_ops_write_and_read = &linux_spi_write_and_read,
+	.spi_ops_transfer = &linux_spi_transfer,
 	.spi_ops_remove = &linux_spi_remove
 };
@@ -44,13 +44,27 @@
 #include "uart.h"
 #include "linux_uart.h"
 
+#include <errno.h>
 #include <fcntl.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <termios.h>
+#include <string.h>
+#include <time.h>
 #include <unistd.h>
+#include <asm/termbits.h>
 #include <sys/ioctl.h>
 
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define LINUX_UART_RX_BUFF_SIZE		16384
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -63,15 +77,116 @@ struct linux_uart_desc {
 	/** /dev/"device_id" file descriptor */
 	int fd;
 	/** structure containing the terminal flags/settings */
-	struct termios *terminal;
+	struct termios2 *terminal;
+	/** Timeout of a read or write in milliseconds, 0 to wait forever */
+	uint32_t timeout_ms;
+	/** Bytes read from the device and not yet returned to the caller */
+	uint8_t *rx_buff;
+	/** Size of rx_buff */
+	uint32_t rx_size;
+	/** Index of the first unread byte of rx_buff */
+	uint32_t rx_pos;
+	/** Number of valid bytes in rx_buff */
+	uint32_t rx_len;
 };
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+/**
+ * @brief Get a monotonic time stamp.
+ * @return The time in milliseconds.
+ */
+static uint64_t linux_uart_time_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Sleep until the device is ready or the deadline expires.
+ * @param linux_desc - The Linux UART descriptor.
+ * @param events - POLLIN or POLLOUT.
+ * @param deadline - Time stamp returned by linux_uart_time_ms(), unused if the
+ *		     descriptor has no timeout.
+ * @return SUCCESS if the device is ready, -ETIMEDOUT or -EIO otherwise.
+ */
+static int32_t linux_uart_wait(struct linux_uart_desc *linux_desc,
+			       short events, uint64_t deadline)
+{
+	struct pollfd pfd;
+	uint64_t now;
+	int timeout;
+	int ret;
+
+	pfd.fd = linux_desc->fd;
+	pfd.events = events;
+
+	while (true) {
+		timeout = -1;
+		if (linux_desc->timeout_ms) {
+			now = linux_uart_time_ms();
+			if (now >= deadline)
+				return -ETIMEDOUT;
+			timeout = deadline - now;
+		}
+
+		ret = poll(&pfd, 1, timeout);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			return -EIO;
+		}
+		if (ret == 0)
+			return -ETIMEDOUT;
+		if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL))
+			return -EIO;
+
+		return SUCCESS;
+	}
+}
+
+/**
+ * @brief Read from the device, sleeping until data is available.
+ * @param linux_desc - The Linux UART descriptor.
+ * @param data - Buffer where the data is stored.
+ * @param size - Size of the buffer. All the bytes the kernel has buffered, up
+ *		 to this size, are read at once.
+ * @param deadline - Time stamp returned by linux_uart_time_ms().
+ * @return Number of bytes read in case of success, negative error code
+ *	   otherwise.
+ */
+static int32_t linux_uart_read_bulk(struct linux_uart_desc *linux_desc,
+				    uint8_t *data, uint32_t size,
+				    uint64_t deadline)
+{
+	ssize_t ret;
+	int32_t err;
+
+	while (true) {
+		ret = read(linux_desc->fd, data, size);
+		if (ret > 0)
+			return ret;
+		/* With VMIN and VTIME at 0, no data reads as 0 bytes */
+		if (ret < 0 && errno != EAGAIN && errno != EINTR)
+			return -EIO;
+
+		err = linux_uart_wait(linux_desc, POLLIN, deadline);
+		if (err != SUCCESS)
+			return err;
+	}
+}
+
 /**
  * @brief Initialize the UART communication peripheral.
+ *
+ * The baud rate is set with termios2 and BOTHER, so any rate the adapter
+ * supports may be used, not only the standard ones.
+ *
  * @param desc - The UART descriptor.
  * @param param - The structure that contains the UART parameters.
  * @return SUCCESS in case of success, error code otherwise.
@@ -81,98 +196,77 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 	struct linux_uart_init_param *linux_init;
 	struct linux_uart_desc *linux_desc;
 	struct uart_desc *descriptor;
-	speed_t speed;
 	char path[64];
 	int ret;
 
+	if (!param || !param->baud_rate)
+		return -EINVAL;
+
 	descriptor = malloc(sizeof(*descriptor));
 	if (!descriptor)
 		return -ENOMEM;
 
-	linux_desc = (struct linux_uart_desc*) malloc(sizeof(struct linux_uart_desc));
+	linux_desc = (struct linux_uart_desc*) calloc(1, sizeof(*linux_desc));
 	if (!linux_desc) {
 		ret = -ENOMEM;
 		goto free_desc;
 	}
 
-	linux_desc->terminal = (struct termios*) malloc(sizeof(struct termios));
+	linux_desc->terminal = (struct termios2*) malloc(sizeof(struct termios2));
 	if (!linux_desc->terminal) {
 		ret = -ENOMEM;
 		goto free_linux_desc;
 	}
 
 	descriptor->extra = linux_desc;
+	descriptor->baud_rate = param->baud_rate;
 	linux_init = param->extra;
 
+	linux_desc->timeout_ms = linux_init->timeout_ms;
+	linux_desc->rx_size = linux_init->rx_buffer_size ?
+			      linux_init->rx_buffer_size :
+			      LINUX_UART_RX_BUFF_SIZE;
+	linux_desc->rx_buff = (uint8_t *)malloc(linux_desc->rx_size);
+	if (!linux_desc->rx_buff) {
+		ret = -ENOMEM;
+		goto free_terminal;
+	}
+
 	ret = snprintf(path, sizeof(path), "/dev/%s", linux_init->device_id);
-	if (ret < 0 || ret >= sizeof(path)) {
+	if (ret < 0 || (size_t)ret >= sizeof(path)) {
 		ret = -ENOMEM;
-		goto free_linux_desc;
+		goto free_rx_buff;
 	}
 
+	/* Reads and writes never block, poll() does the waiting. */
 	linux_desc->fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
 	if (linux_desc->fd < 0) {
 		printf("%s: Can't open %s\n\r", __func__, path);
 		ret = -ENOENT;
-		goto free_terminal;
+		goto free_rx_buff;
 	}
 
-	tcgetattr(linux_desc->fd, linux_desc->terminal);
-
-	cfmakeraw(linux_desc->terminal);
-
-	switch(param->baud_rate) {
-	case 50:
-		speed = B50;
-		break;
-	case 75:
-		speed = B75;
-		break;
-	case 110:
-		speed = B110;
-		break;
-	case 134:
-		speed = B134;
-		break;
-	case 150:
-		speed = B150;
-		break;
-	case 200:
-		speed = B200;
-		break;
-	case 300:
-		speed = B300;
-		break;
-	case 600:
-		speed = B600;
-		break;
-	case 1200:
-		speed = B1200;
-		break;
-	case 1800:
-		speed = B1800;
-		break;
-	case 2400:
-		speed = B2400;
-		break;
-	case 4800:
-		speed = B4800;
-		break;
-	case 9600:
-		speed = B9600;
-		break;
-	case 19200:
-		speed = B19200;
-		break;
-	case 38400:
-		speed = B38400;
-		break;
-	default:
-		ret = -EINVAL;
+	ret = ioctl(linux_desc->fd, TCGETS2, linux_desc->terminal);
+	if (ret < 0) {
+		ret = -EIO;
 		goto free;
 	}
-	cfsetispeed(linux_desc->terminal, speed);
-	cfsetospeed(linux_desc->terminal, speed);
+
+	/* Raw mode, same as cfmakeraw() */
+	linux_desc->terminal->c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP |
+					   INLCR | IGNCR | ICRNL | IXON);
+	linux_desc->terminal->c_oflag &= ~OPOST;
+	linux_desc->terminal->c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG |
+					   IEXTEN);
+
+	/* A read returns whatever is available, without an inter byte timer */
+	linux_desc->terminal->c_cc[VMIN] = 0;
+	linux_desc->terminal->c_cc[VTIME] = 0;
+
+	linux_desc->terminal->c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+	linux_desc->terminal->c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+	linux_desc->terminal->c_ispeed = param->baud_rate;
+	linux_desc->terminal->c_ospeed = param->baud_rate;
 
 	linux_desc->terminal->c_cflag &= ~CSIZE;
 	switch(param->size) {
@@ -199,7 +293,7 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 	case UART_PAR_NO:
 		break;
 	case UART_PAR_ODD:
-		linux_desc->terminal->c_cflag |= PARODD;
+		linux_desc->terminal->c_cflag |= PARENB | PARODD;
 		break;
 	case UART_PAR_EVEN:
 		linux_desc->terminal->c_cflag |= PARENB;
@@ -216,9 +310,15 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 
 	linux_desc->terminal->c_cflag |= CREAD;
 
-	tcsetattr(linux_desc->fd, TCSANOW, linux_desc->terminal);
+	ret = ioctl(linux_desc->fd, TCSETS2, linux_desc->terminal);
+	if (ret < 0) {
+		printf("%s: Can't set %"PRIu32" baud\n\r", __func__,
+		       param->baud_rate);
+		ret = -EINVAL;
+		goto free;
+	}
 
-	tcflush(linux_desc->fd, TCIOFLUSH);
+	ioctl(linux_desc->fd, TCFLSH, TCIOFLUSH);
 
 	*desc = descriptor;
 
@@ -226,6 +326,8 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 
 free:
 	close(linux_desc->fd);
+free_rx_buff:
+	free(linux_desc->rx_buff);
 free_terminal:
 	free(linux_desc->terminal);
 free_linux_desc:
@@ -252,6 +354,8 @@ int32_t uart_remove(struct uart_desc *desc)
 	if (ret < 0)
 		printf("%s: Can't close device\n\r", __func__);
 
+	free(linux_desc->rx_buff);
+	free(linux_desc->terminal);
 	free(desc->extra);
 	free(desc);
 
@@ -263,21 +367,33 @@ int32_t uart_remove(struct uart_desc *desc)
  * @param desc - Instance of UART.
  * @param data - Pointer to buffer containing data.
  * @param bytes_number - Number of bytes to read.
- * @return SUCCESS in case of success, FAILURE otherwise.
+ * @return SUCCESS in case of success, -ETIMEDOUT if the timeout expired,
+ *	   -EIO otherwise.
  */
 int32_t uart_write(struct uart_desc *desc, const uint8_t *data,
 		   uint32_t bytes_number)
 {
 	struct linux_uart_desc *linux_desc;
-	ssize_t count = 0;
-	int32_t ret;
+	uint32_t count = 0;
+	uint64_t deadline;
+	ssize_t ret;
+	int32_t err;
 
 	linux_desc = desc->extra;
+	deadline = linux_uart_time_ms() + linux_desc->timeout_ms;
 
 	while (count < bytes_number) {
-		ret = write(linux_desc->fd, data, bytes_number);
-		if (ret > 0)
+		ret = write(linux_desc->fd, &data[count], bytes_number - count);
+		if (ret > 0) {
 			count += ret;
+			continue;
+		}
+		if (ret < 0 && errno != EAGAIN && errno != EINTR)
+			return -EIO;
+
+		err = linux_uart_wait(linux_desc, POLLOUT, deadline);
+		if (err != SUCCESS)
+			return err;
 	}
 
 	return SUCCESS;
@@ -285,25 +401,80 @@ int32_t uart_write(struct uart_desc *desc, const uint8_t *data,
 
 /**
  * @brief Read data from UART device.
+ *
+ * Every read from the device takes all the bytes the kernel has buffered, so
+ * short reads, like the ones of the IIO protocol, are mostly served from
+ * memory. The calling thread sleeps while no data is available.
+ *
+ * A read either returns all the requested bytes or none. On error, the bytes
+ * already received are kept and returned first by the next call, so the
+ * stream stays in sync.
+ *
  * @param desc - Instance of UART.
  * @param data - Pointer to buffer containing data.
  * @param bytes_number - Number of bytes to read.
- * @return SUCCESS in case of success, FAILURE otherwise.
+ * @return SUCCESS in case of success, -ETIMEDOUT if the timeout expired,
+ *	   -EIO otherwise.
  */
 int32_t uart_read(struct uart_desc *desc, uint8_t *data,
 		  uint32_t bytes_number)
 {
 	struct linux_uart_desc *linux_desc;
-	ssize_t count = 0;
-	ssize_t ret;
+	uint32_t count = 0;
+	uint64_t deadline;
+	uint8_t *buff;
+	uint32_t len;
+	int32_t ret;
 
 	linux_desc = desc->extra;
+	deadline = linux_uart_time_ms() + linux_desc->timeout_ms;
 
 	while (count < bytes_number) {
-		ret = read(linux_desc->fd, &data[count], bytes_number - count);
-		if (ret > 0)
-			count += ret;
+		if (linux_desc->rx_pos == linux_desc->rx_len) {
+			/* Big requests skip the copy through rx_buff */
+			if (bytes_number - count >= linux_desc->rx_size) {
+				ret = linux_uart_read_bulk(linux_desc,
+							   &data[count],
+							   bytes_number - count,
+							   deadline);
+				if (ret < 0)
+					goto unread;
+				count += ret;
+				continue;
+			}
+
+			ret = linux_uart_read_bulk(linux_desc,
+						   linux_desc->rx_buff,
+						   linux_desc->rx_size,
+						   deadline);
+			if (ret < 0)
+				goto unread;
+			linux_desc->rx_pos = 0;
+			linux_desc->rx_len = ret;
+		}
+
+		len = min(bytes_number - count,
+			  linux_desc->rx_len - linux_desc->rx_pos);
+		memcpy(&data[count], &linux_desc->rx_buff[linux_desc->rx_pos],
+		       len);
+		linux_desc->rx_pos += len;
+		count += len;
 	}
 
 	return SUCCESS;
+
+unread:
+	/* rx_buff is empty here, it only gets refilled once consumed */
+	if (count > linux_desc->rx_size) {
+		buff = realloc(linux_desc->rx_buff, count);
+		if (!buff)
+			return -ENOMEM;
+		linux_desc->rx_buff = buff;
+		linux_desc->rx_size = count;
+	}
+	memcpy(linux_desc->rx_buff, data, count);
+	linux_desc->rx_pos = 0;
+	linux_desc->rx_len = count;
+
+	return ret;
 };
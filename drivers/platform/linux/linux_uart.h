@@ -39,6 +39,8 @@
 #ifndef LINUX_UART_H_
 #define LINUX_UART_H_
 
+#include <stdint.h>
+
 /**
  * @struct linux_uart_init_param
  * @brief Structure holding the initialization parameters for Linux platform
@@ -47,6 +49,11 @@
 struct linux_uart_init_param {
 	/** UART device ID (/dev/"device_id") */
 	const char *device_id;
+	/** Timeout of uart_read() and uart_write() in milliseconds. 0 to wait
+	 * forever */
+	uint32_t timeout_ms;
+	/** Size of the receive buffer. 0 for the default of 16 KiB */
+	uint32_t rx_buffer_size;
 };
 
 #endif // LINUX_UART_H_
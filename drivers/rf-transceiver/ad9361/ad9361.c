@@ -899,6 +899,96 @@ static int32_t ad9361_spi_writem(struct spi_desc *spi,
 	return 0;
 }
 
+/* Command and up to 4 data bytes, see ad9361_spi_image_put() */
+#define AD9361_SPI_IMAGE_FRAME	6
+
+/**
+ * Free an SPI image.
+ * @param img The image.
+ * @return None.
+ */
+static void ad9361_spi_image_free(struct ad9361_spi_image *img)
+{
+	free(img->buf);
+	free(img->msgs);
+	img->buf = NULL;
+	img->msgs = NULL;
+	img->nb_msgs = 0;
+}
+
+/**
+ * Allocate an SPI image.
+ * @param img The image.
+ * @param nb_msgs The number of write instructions.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_spi_image_alloc(struct ad9361_spi_image *img,
+				      uint32_t nb_msgs)
+{
+	img->buf = malloc(nb_msgs * AD9361_SPI_IMAGE_FRAME);
+	img->msgs = calloc(nb_msgs, sizeof(*img->msgs));
+	img->nb_msgs = 0;
+	if (!img->buf || !img->msgs) {
+		ad9361_spi_image_free(img);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+/**
+ * Append a multi-register write to an SPI image. The addresses decrement,
+ * data[0] goes to reg, data[1] to reg - 1 and so on.
+ * @param img The image.
+ * @param reg The first register address.
+ * @param data The data bytes.
+ * @param num The number of bytes, 4 at most.
+ * @param delay_us Delay after the write.
+ * @return None.
+ */
+static void ad9361_spi_image_put(struct ad9361_spi_image *img, uint32_t reg,
+				 const uint8_t *data, uint32_t num,
+				 uint32_t delay_us)
+{
+	uint8_t *frame = &img->buf[img->nb_msgs * AD9361_SPI_IMAGE_FRAME];
+	struct spi_msg *msg = &img->msgs[img->nb_msgs];
+	uint16_t cmd;
+
+	cmd = AD_WRITE | AD_CNT(num) | AD_ADDR(reg);
+	frame[0] = cmd >> 8;
+	frame[1] = cmd & 0xFF;
+	memcpy(&frame[2], data, num);
+
+	msg->tx_buff = frame;
+	msg->rx_buff = NULL;
+	msg->bytes_number = num + 2;
+	msg->delay_us = delay_us;
+	msg->cs_change = 0;
+	/* Every write is a separate instruction */
+	if (img->nb_msgs)
+		img->msgs[img->nb_msgs - 1].cs_change = 1;
+
+	img->nb_msgs++;
+}
+
+/**
+ * Send an SPI image in a single message.
+ * @param spi The SPI descriptor.
+ * @param img The image.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_spi_image_write(struct spi_desc *spi,
+				      struct ad9361_spi_image *img)
+{
+	int32_t ret;
+
+	ret = spi_transfer(spi, img->msgs, img->nb_msgs);
+	if (ret < 0)
+		dev_err(&spi->dev, "Write Error %"PRId32, ret);
+
+	return ret;
+}
+
 /**
  * Validate RF BW frequency.
  * @param phy The AD9361 state structure.
@@ -1399,6 +1489,86 @@ static int find_table_index(struct ad9361_rf_phy *phy, int gain)
 	return -EINVAL;
 }
 
+/**
+ * Build the SPI image that writes a gain table. Each index is written with
+ * two instructions: the data words and the address, then the write strobe
+ * followed by dummy writes to the read data registers as delay.
+ * @param phy The AD9361 state structure.
+ * @param band The gain table.
+ * @param dest The destination [GT_RX1, GT_RX2].
+ * @param lna The external LNA control bit added to every index.
+ * @param img The image.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_gt_image_build(struct ad9361_rf_phy *phy, uint32_t band,
+				     uint32_t dest, uint8_t lna,
+				     struct ad9361_gt_image *img)
+{
+	uint8_t (*tab)[3] = phy->gt_info[band].tab;
+	uint32_t index_max = phy->gt_info[band].max_index;
+	uint32_t i, lpf_tia_mask;
+	uint8_t buf[4] = { 0 };
+	int32_t ret;
+
+	ret = ad9361_spi_image_alloc(&img->spi, 2 * index_max + 3);
+	if (ret < 0)
+		return ret;
+
+	buf[0] = START_GAIN_TABLE_CLOCK | RECEIVER_SELECT(dest);
+	ad9361_spi_image_put(&img->spi, REG_GAIN_TABLE_CONFIG, buf, 1,
+			     0); /* Start Gain Table Clock */
+
+	/* TX QUAD Calibration */
+	if (phy->pdata->split_gt)
+		lpf_tia_mask = 0x20;
+	else
+		lpf_tia_mask = 0x3F;
+
+	img->tx_quad_lpf_tia_match = -EINVAL;
+
+	for (i = 0; i < index_max; i++) {
+		buf[0] = tab[i][2]; /* DC Cal bit & Dig Gain Word */
+		buf[1] = tab[i][1]; /* TIA & LPF Word */
+		buf[2] = tab[i][0] | lna; /* Ext LNA, Int LNA, & Mixer Gain Word */
+		buf[3] = i; /* Gain Table Index */
+		ad9361_spi_image_put(&img->spi, REG_GAIN_TABLE_WRITE_DATA3, buf,
+				     4, 0);
+
+		buf[0] = START_GAIN_TABLE_CLOCK | WRITE_GAIN_TABLE |
+			 RECEIVER_SELECT(dest);
+		buf[1] = buf[2] = buf[3] = 0; /* Dummy Writes to delay ~1u */
+		ad9361_spi_image_put(&img->spi, REG_GAIN_TABLE_CONFIG, buf, 4, 1);
+
+		if ((tab[i][1] & lpf_tia_mask) == 0x20)
+			img->tx_quad_lpf_tia_match = i;
+	}
+
+	buf[0] = START_GAIN_TABLE_CLOCK | RECEIVER_SELECT(dest); /* Clear Write Bit */
+	ad9361_spi_image_put(&img->spi, REG_GAIN_TABLE_CONFIG, buf, 4, 1);
+	buf[0] = 0;
+	ad9361_spi_image_put(&img->spi, REG_GAIN_TABLE_CONFIG, buf, 1,
+			     0); /* Stop Gain Table Clock */
+
+	img->dest = dest;
+	img->lna = lna;
+
+	return 0;
+}
+
+/**
+ * Free the cached gain table images. Must be called when phy->gt_info is
+ * changed.
+ * @param phy The AD9361 state structure.
+ * @return None.
+ */
+void ad9361_gt_image_flush(struct ad9361_rf_phy *phy)
+{
+	uint32_t i;
+
+	for (i = 0; i < AD9361_GT_IMAGE_CACHE_SIZE; i++)
+		ad9361_spi_image_free(&phy->gt_image[i].spi);
+}
+
 /**
  * Load the gain table for the selected frequency range and receiver.
  * @param phy The AD9361 state structure.
@@ -1410,8 +1580,8 @@ static int32_t ad9361_load_gt(struct ad9361_rf_phy *phy, uint64_t freq,
 			      uint32_t dest)
 {
 	struct spi_desc *spi = phy->spi;
-	uint8_t (*tab)[3];
-	uint32_t band, index_max, i, lna, lpf_tia_mask, set_gain;
+	struct ad9361_gt_image *img, tmp = { 0 };
+	uint32_t band, index_max, lna, set_gain;
 	int32_t ret, rx1_gain, rx2_gain;
 
 	dev_dbg(&phy->spi->dev, "%s: frequency %"PRIu64, __func__, freq);
@@ -1425,7 +1595,6 @@ static int32_t ad9361_load_gt(struct ad9361_rf_phy *phy, uint64_t freq,
 	if (phy->current_table == band)
 		return 0;
 
-	tab = phy->gt_info[band].tab;
 	index_max = phy->gt_info[band].max_index;
 
 	ad9361_spi_writef(spi, REG_AGC_CONFIG_2,
@@ -1461,46 +1630,25 @@ static int32_t ad9361_load_gt(struct ad9361_rf_phy *phy, uint64_t freq,
 	lna = phy->pdata->elna_ctrl.elna_in_gaintable_all_index_en ?
 	      EXT_LNA_CTRL : 0;
 
-	ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG, START_GAIN_TABLE_CLOCK |
-			 RECEIVER_SELECT(dest)); /* Start Gain Table Clock */
-
-	/* TX QUAD Calibration */
-	if (phy->pdata->split_gt)
-		lpf_tia_mask = 0x20;
+	/* Replay the band image, built once per band */
+	if (band < AD9361_GT_IMAGE_CACHE_SIZE)
+		img = &phy->gt_image[band];
 	else
-		lpf_tia_mask = 0x3F;
-
-	phy->tx_quad_lpf_tia_match = -EINVAL;
-
-	for (i = 0; i < index_max; i++) {
-		ad9361_spi_write(spi, REG_GAIN_TABLE_ADDRESS, i); /* Gain Table Index */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_WRITE_DATA1,
-				 tab[i][0] | lna); /* Ext LNA, Int LNA, & Mixer Gain Word */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_WRITE_DATA2,
-				 tab[i][1]); /* TIA & LPF Word */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_WRITE_DATA3,
-				 tab[i][2]); /* DC Cal bit & Dig Gain Word */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG,
-				 START_GAIN_TABLE_CLOCK |
-				 WRITE_GAIN_TABLE |
-				 RECEIVER_SELECT(dest)); /* Gain Table Index */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
-				 0); /* Dummy Write to delay 3 ADCCLK/16 cycles */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
-				 0); /* Dummy Write to delay ~1u */
-
-		if ((tab[i][1] & lpf_tia_mask) == 0x20)
-			phy->tx_quad_lpf_tia_match = i;
+		img = &tmp;
 
+	if (!img->spi.nb_msgs || img->dest != dest || img->lna != lna) {
+		ad9361_spi_image_free(&img->spi);
+		ret = ad9361_gt_image_build(phy, band, dest, lna, img);
+		if (ret < 0)
+			return ret;
 	}
 
-	ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG, START_GAIN_TABLE_CLOCK |
-			 RECEIVER_SELECT(dest)); /* Clear Write Bit */
-	ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
-			 0); /* Dummy Write to delay ~1u */
-	ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
-			 0); /* Dummy Write to delay ~1u */
-	ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG, 0); /* Stop Gain Table Clock */
+	ret = ad9361_spi_image_write(spi, &img->spi);
+	phy->tx_quad_lpf_tia_match = img->tx_quad_lpf_tia_match;
+	if (img == &tmp)
+		ad9361_spi_image_free(&tmp.spi);
+	if (ret < 0)
+		return ret;
 
 	phy->current_table = band;
 
@@ -4592,6 +4740,43 @@ static int32_t ad9361_validate_trx_clock_chain(struct ad9361_rf_phy *phy,
 	return -EINVAL;
 }
 
+/**
+ * Finish a RX and TX path rate change: restore the FIR enables, re-run the
+ * digital interface tuning if needed and notify the baseband clock users.
+ * @param phy The AD9361 state structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_trx_clock_chain_done(struct ad9361_rf_phy *phy)
+{
+	/*
+	 * Workaround for clock framework since clocks don't change we
+	 * manually need to enable the filter
+	 */
+
+	if (phy->rx_fir_dec == 1 || phy->bypass_rx_fir) {
+		ad9361_spi_writef(phy->spi, REG_RX_ENABLE_FILTER_CTRL,
+				  RX_FIR_ENABLE_DECIMATION(~0), !phy->bypass_rx_fir);
+	}
+
+	if (phy->tx_fir_int == 1 || phy->bypass_tx_fir) {
+		ad9361_spi_writef(phy->spi, REG_TX_ENABLE_FILTER_CTRL,
+				  TX_FIR_ENABLE_INTERPOLATION(~0), !phy->bypass_tx_fir);
+	}
+
+	/* The FIR filter once enabled causes the interface timing to change.
+	 * It's typically not a problem if the timing margin is big enough.
+	 * However at 61.44 MSPS it causes problems on some systems.
+	 * So we always run the digital tune in case the filter is enabled.
+	 * If it is disabled we restore the values from the initial calibration.
+	 */
+
+	if (!phy->pdata->dig_interface_tune_fir_disable &&
+	    !(phy->bypass_tx_fir && phy->bypass_rx_fir))
+		ad9361_dig_tune(phy, 0, SKIP_STORE_RESULT);
+
+	return ad9361_bb_clk_change_handler(phy);
+}
+
 /**
  * Set the RX and TX path rates.
  * @param phy The AD9361 state structure.
@@ -4651,33 +4836,7 @@ int32_t ad9361_set_trx_clock_chain(struct ad9361_rf_phy *phy,
 		phy->current_tx_path_clks[n] = tx_path_clks[n];
 	}
 
-	/*
-	 * Workaround for clock framework since clocks don't change we
-	 * manually need to enable the filter
-	 */
-
-	if (phy->rx_fir_dec == 1 || phy->bypass_rx_fir) {
-		ad9361_spi_writef(phy->spi, REG_RX_ENABLE_FILTER_CTRL,
-				  RX_FIR_ENABLE_DECIMATION(~0), !phy->bypass_rx_fir);
-	}
-
-	if (phy->tx_fir_int == 1 || phy->bypass_tx_fir) {
-		ad9361_spi_writef(phy->spi, REG_TX_ENABLE_FILTER_CTRL,
-				  TX_FIR_ENABLE_INTERPOLATION(~0), !phy->bypass_tx_fir);
-	}
-
-	/* The FIR filter once enabled causes the interface timing to change.
-	 * It's typically not a problem if the timing margin is big enough.
-	 * However at 61.44 MSPS it causes problems on some systems.
-	 * So we always run the digital tune in case the filter is enabled.
-	 * If it is disabled we restore the values from the initial calibration.
-	 */
-
-	if (!phy->pdata->dig_interface_tune_fir_disable &&
-	    !(phy->bypass_tx_fir && phy->bypass_rx_fir))
-		ret = ad9361_dig_tune(phy, 0, SKIP_STORE_RESULT);
-
-	return ad9361_bb_clk_change_handler(phy);
+	return ad9361_trx_clock_chain_done(phy);
 }
 
 /**
@@ -4841,6 +5000,196 @@ int32_t ad9361_calculate_rf_clock_chain(struct ad9361_rf_phy *phy,
 	return 0;
 }
 
+/**
+ * Check if a cached sample rate plan matches the current configuration.
+ * The plan depends on everything ad9361_calculate_rf_clock_chain() and
+ * ad9361_set_clk_scaler() look at, not only on the requested rate.
+ * @param phy The AD9361 state structure.
+ * @param plan The cached plan.
+ * @param freq The desired sample rate.
+ * @return true if the plan can be replayed, false otherwise.
+ */
+static bool ad9361_rate_plan_match(struct ad9361_rf_phy *phy,
+				   struct ad9361_rate_plan *plan,
+				   uint32_t freq)
+{
+	return plan->valid && plan->freq == freq &&
+	       plan->ref_rate == phy->clks[BB_REFCLK]->rate &&
+	       plan->rate_governor == phy->rate_governor &&
+	       plan->rx_fir_dec == phy->rx_fir_dec &&
+	       plan->tx_fir_int == phy->tx_fir_int &&
+	       plan->bypass_rx_fir == phy->bypass_rx_fir &&
+	       plan->bypass_tx_fir == phy->bypass_tx_fir &&
+	       plan->rx_eq_2tx == phy->rx_eq_2tx;
+}
+
+/**
+ * Look up a sample rate plan in the cache.
+ * @param phy The AD9361 state structure.
+ * @param freq The desired sample rate.
+ * @return The matching plan or NULL if there is none.
+ */
+static struct ad9361_rate_plan *ad9361_rate_plan_find(
+	struct ad9361_rf_phy *phy, uint32_t freq)
+{
+	struct ad9361_rate_plan *plan;
+	uint32_t i;
+
+	for (i = 0; i < AD9361_RATE_PLAN_CACHE_SIZE; i++) {
+		plan = &phy->rate_plans.plan[i];
+		if (ad9361_rate_plan_match(phy, plan, freq)) {
+			plan->last_used = ++phy->rate_plans.use_count;
+			return plan;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Save the clock chain that was just programmed as a sample rate plan,
+ * replacing the least recently used entry if the cache is full.
+ * @param phy The AD9361 state structure.
+ * @param freq The sample rate that was requested.
+ * @return None.
+ */
+static void ad9361_rate_plan_store(struct ad9361_rf_phy *phy, uint32_t freq)
+{
+	struct ad9361_rate_plan *plan = &phy->rate_plans.plan[0];
+	struct refclk_scale *scale;
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < AD9361_RATE_PLAN_CACHE_SIZE; i++) {
+		if (!phy->rate_plans.plan[i].valid) {
+			plan = &phy->rate_plans.plan[i];
+			break;
+		}
+		if (phy->rate_plans.plan[i].last_used < plan->last_used)
+			plan = &phy->rate_plans.plan[i];
+	}
+
+	plan->valid = false;
+
+	ret = ad9361_spi_readm(phy->spi, REG_INTEGER_BB_FREQ_WORD,
+			       plan->bb_freq_word, ARRAY_SIZE(plan->bb_freq_word));
+	if (ret < 0)
+		return;
+	ret = ad9361_spi_read(phy->spi, REG_CP_CURRENT);
+	if (ret < 0)
+		return;
+	plan->cp_current = ret;
+	ret = ad9361_spi_read(phy->spi, REG_BBPLL);
+	if (ret < 0)
+		return;
+	plan->bbpll = ret & AD9361_RATE_PLAN_BBPLL_MASK;
+	ret = ad9361_spi_readm(phy->spi, REG_RX_ENABLE_FILTER_CTRL,
+			       plan->filter_ctrl, ARRAY_SIZE(plan->filter_ctrl));
+	if (ret < 0)
+		return;
+	plan->filter_ctrl[0] &= AD9361_RATE_PLAN_FILTER_MASK;
+	plan->filter_ctrl[1] &= AD9361_RATE_PLAN_FILTER_MASK;
+
+	for (i = BBPLL_CLK; i <= TX_SAMPL_CLK; i++) {
+		scale = phy->ref_clk_scale[i];
+		plan->clk_rate[i - BBPLL_CLK] = phy->clks[i]->rate;
+		plan->clk_mult[i - BBPLL_CLK] = scale->mult;
+		plan->clk_div[i - BBPLL_CLK] = scale->div;
+	}
+
+	memcpy(plan->rx_path_clks, phy->current_rx_path_clks,
+	       sizeof(plan->rx_path_clks));
+	memcpy(plan->tx_path_clks, phy->current_tx_path_clks,
+	       sizeof(plan->tx_path_clks));
+
+	plan->freq = freq;
+	plan->ref_rate = phy->clks[BB_REFCLK]->rate;
+	plan->rate_governor = phy->rate_governor;
+	plan->rx_fir_dec = phy->rx_fir_dec;
+	plan->tx_fir_int = phy->tx_fir_int;
+	plan->bypass_rx_fir = phy->bypass_rx_fir;
+	plan->bypass_tx_fir = phy->bypass_tx_fir;
+	plan->rx_eq_2tx = phy->rx_eq_2tx;
+	plan->last_used = ++phy->rate_plans.use_count;
+	plan->valid = true;
+}
+
+/**
+ * Program a cached sample rate plan. The BBPLL is only relocked when its
+ * rate changes; the frequency word and the loop settings go out as burst
+ * writes and the decimation/interpolation settings as a single
+ * read-modify-write of the two filter control registers.
+ * @param phy The AD9361 state structure.
+ * @param plan The cached plan.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_rate_plan_apply(struct ad9361_rf_phy *phy,
+				      struct ad9361_rate_plan *plan)
+{
+	/* VCO_CTRL followed by the LOOP_FILTER_3..1 defaults */
+	uint8_t vco_lf[4] = { FREQ_CAL_ENABLE | FREQ_CAL_COUNT_LENGTH(3),
+			      0x35, 0x5B, 0xE8
+			    };
+	struct refclk_scale *scale;
+	uint8_t filter_ctrl[2];
+	uint32_t i;
+	int32_t ret;
+
+	if (!phy->bbpll_initialized ||
+	    phy->clks[BBPLL_CLK]->rate != plan->clk_rate[0]) {
+		ad9361_spi_write(phy->spi, REG_CP_CURRENT, plan->cp_current);
+		ad9361_spi_writem(phy->spi, REG_VCO_CTRL, vco_lf,
+				  ARRAY_SIZE(vco_lf));
+		ad9361_spi_write(phy->spi, REG_SDM_CTRL, 0x10);
+		ad9361_spi_writem(phy->spi, REG_INTEGER_BB_FREQ_WORD,
+				  plan->bb_freq_word,
+				  ARRAY_SIZE(plan->bb_freq_word));
+		ad9361_spi_write(phy->spi, REG_SDM_CTRL_1,
+				 INIT_BB_FO_CAL | BBPLL_RESET_BAR);
+		ad9361_spi_write(phy->spi, REG_SDM_CTRL_1, BBPLL_RESET_BAR);
+		ad9361_spi_write(phy->spi, REG_VCO_PROGRAM_1, 0x86);
+		ad9361_spi_write(phy->spi, REG_VCO_PROGRAM_2, 0x01);
+		ad9361_spi_write(phy->spi, REG_VCO_PROGRAM_2, 0x05);
+
+		ret = ad9361_check_cal_done(phy, REG_CH_1_OVERFLOW,
+					    BBPLL_LOCK, 1);
+		if (ret < 0)
+			return ret;
+	}
+
+	ret = ad9361_spi_writef(phy->spi, REG_BBPLL,
+				AD9361_RATE_PLAN_BBPLL_MASK, plan->bbpll);
+	if (ret < 0)
+		return ret;
+
+	ret = ad9361_spi_readm(phy->spi, REG_RX_ENABLE_FILTER_CTRL,
+			       filter_ctrl, ARRAY_SIZE(filter_ctrl));
+	if (ret < 0)
+		return ret;
+	for (i = 0; i < ARRAY_SIZE(filter_ctrl); i++)
+		filter_ctrl[i] = (filter_ctrl[i] & ~AD9361_RATE_PLAN_FILTER_MASK) |
+				 plan->filter_ctrl[i];
+	ret = ad9361_spi_writem(phy->spi, REG_RX_ENABLE_FILTER_CTRL,
+				filter_ctrl, ARRAY_SIZE(filter_ctrl));
+	if (ret < 0)
+		return ret;
+
+	for (i = BBPLL_CLK; i <= TX_SAMPL_CLK; i++) {
+		scale = phy->ref_clk_scale[i];
+		phy->clks[i]->rate = plan->clk_rate[i - BBPLL_CLK];
+		scale->mult = plan->clk_mult[i - BBPLL_CLK];
+		scale->div = plan->clk_div[i - BBPLL_CLK];
+	}
+	phy->bbpll_initialized = true;
+
+	memcpy(phy->current_rx_path_clks, plan->rx_path_clks,
+	       sizeof(phy->current_rx_path_clks));
+	memcpy(phy->current_tx_path_clks, plan->tx_path_clks,
+	       sizeof(phy->current_tx_path_clks));
+
+	return 0;
+}
+
 /**
  * Set the desired sample rate.
  * @param phy The AD9361 state structure.
@@ -4850,14 +5199,46 @@ int32_t ad9361_calculate_rf_clock_chain(struct ad9361_rf_phy *phy,
 int32_t ad9361_set_trx_clock_chain_freq(struct ad9361_rf_phy *phy,
 					uint32_t freq)
 {
+	struct ad9361_rate_plan *plan;
 	uint32_t rx[6], tx[6];
 	int32_t ret;
 
+	plan = ad9361_rate_plan_find(phy, freq);
+	if (plan) {
+		phy->rate_plans.hits++;
+		ret = ad9361_rate_plan_apply(phy, plan);
+		if (ret == 0)
+			return ad9361_trx_clock_chain_done(phy);
+		/* Drop the plan and fall back to the full calculation */
+		plan->valid = false;
+	}
+
+	phy->rate_plans.misses++;
+
 	ret = ad9361_calculate_rf_clock_chain(phy, freq,
 					      phy->rate_governor, rx, tx);
 	if (ret < 0)
 		return ret;
-	return ad9361_set_trx_clock_chain(phy, rx, tx);
+	ret = ad9361_set_trx_clock_chain(phy, rx, tx);
+	if (ret < 0)
+		return ret;
+
+	ad9361_rate_plan_store(phy, freq);
+
+	return 0;
+}
+
+/**
+ * Invalidate all the cached sample rate plans.
+ * @param phy The AD9361 state structure.
+ * @return None.
+ */
+void ad9361_rate_plan_flush(struct ad9361_rf_phy *phy)
+{
+	uint32_t i;
+
+	for (i = 0; i < AD9361_RATE_PLAN_CACHE_SIZE; i++)
+		phy->rate_plans.plan[i].valid = false;
 }
 
 /**
@@ -5332,6 +5713,9 @@ int32_t ad9361_setup(struct ad9361_rf_phy *phy)
 
 	dev_dbg(dev, "%s", __func__);
 
+	/* The device is (re)initialized, the cached register images are stale */
+	ad9361_rate_plan_flush(phy);
+
 	pd->rf_rx_bandwidth_Hz = ad9361_validate_rf_bw(phy, pd->rf_rx_bandwidth_Hz);
 	pd->rf_tx_bandwidth_Hz = ad9361_validate_rf_bw(phy, pd->rf_tx_bandwidth_Hz);
 
@@ -5791,7 +6175,9 @@ int32_t ad9361_load_fir_filter_coef(struct ad9361_rf_phy *phy,
 				    uint32_t ntaps, int16_t *coef)
 {
 	struct spi_desc *spi = phy->spi;
+	struct ad9361_spi_image img;
 	uint32_t val, offs = 0, fir_conf = 0, fir_enable = 0;
+	uint8_t buf[3];
 	int32_t ret;
 
 	dev_dbg(&phy->spi->dev, "%s: TAPS %"PRIu32", gain %"PRId32", dest %d",
@@ -5834,23 +6220,36 @@ int32_t ad9361_load_fir_filter_coef(struct ad9361_rf_phy *phy,
 
 	ad9361_spi_write(spi, REG_TX_FILTER_CONF + offs, fir_conf);
 
-	for (val = 0; val < ntaps; val++) {
-		ad9361_spi_write(spi, REG_TX_FILTER_COEF_ADDR + offs, val);
-		ad9361_spi_write(spi, REG_TX_FILTER_COEF_WRITE_DATA_1 + offs,
-				 coef[val] & 0xFF);
-		ad9361_spi_write(spi, REG_TX_FILTER_COEF_WRITE_DATA_2 + offs,
-				 coef[val] >> 8);
-		ad9361_spi_write(spi, REG_TX_FILTER_CONF + offs,
-				 fir_conf | FIR_WRITE);
-		ad9361_spi_write(spi, REG_TX_FILTER_COEF_READ_DATA_2 + offs, 0);
-		ad9361_spi_write(spi, REG_TX_FILTER_COEF_READ_DATA_2 + offs, 0);
+	/*
+	 * Per tap: the coefficient and its address in one instruction, then
+	 * the write strobe followed by dummy writes to the read data registers
+	 * and a delay of ~1u, as for the gain table
+	 */
+	ret = ad9361_spi_image_alloc(&img, 2 * ntaps);
+	if (ret == 0) {
+		for (val = 0; val < ntaps; val++) {
+			buf[0] = coef[val] >> 8;
+			buf[1] = coef[val] & 0xFF;
+			buf[2] = val;
+			ad9361_spi_image_put(&img,
+					     REG_TX_FILTER_COEF_WRITE_DATA_2 + offs,
+					     buf, 3, 0);
+			buf[0] = fir_conf | FIR_WRITE;
+			buf[1] = buf[2] = 0;
+			ad9361_spi_image_put(&img, REG_TX_FILTER_CONF + offs,
+					     buf, 3, 1);
+		}
+
+		ret = ad9361_spi_image_write(spi, &img);
+		ad9361_spi_image_free(&img);
 	}
 
 	ad9361_spi_write(spi, REG_TX_FILTER_CONF + offs, fir_conf);
 	fir_conf &= ~FIR_START_CLK;
 	ad9361_spi_write(spi, REG_TX_FILTER_CONF + offs, fir_conf);
 
-	ret = ad9361_verify_fir_filter_coef(phy, dest, ntaps, coef);
+	if (ret == 0)
+		ret = ad9361_verify_fir_filter_coef(phy, dest, ntaps, coef);
 
 	if (dest & FIR_IS_RX)
 		ad9361_spi_writef(phy->spi, REG_RX_ENABLE_FILTER_CTRL,
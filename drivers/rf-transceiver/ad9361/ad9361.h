@@ -3310,6 +3310,99 @@ struct ad9361_fastlock {
 	struct ad9361_fastlock_entry entry[2][8];
 };
 
+/* REG_BBPLL ADC/DAC clock dividers */
+#define AD9361_RATE_PLAN_BBPLL_MASK	0x0F
+/* REG_RX/TX_ENABLE_FILTER_CTRL filter settings, without the channel enables */
+#define AD9361_RATE_PLAN_FILTER_MASK	0x3F
+#define AD9361_RATE_PLAN_CACHE_SIZE	8
+
+struct ad9361_rate_plan {
+	bool		valid;
+	uint32_t	last_used;
+	/* Key */
+	uint32_t	freq;
+	uint32_t	ref_rate;
+	uint32_t	rate_governor;
+	uint8_t		rx_fir_dec;
+	uint8_t		tx_fir_int;
+	bool		bypass_rx_fir;
+	bool		bypass_tx_fir;
+	bool		rx_eq_2tx;
+	/* Clock chain state, BBPLL_CLK to TX_SAMPL_CLK */
+	uint32_t	rx_path_clks[NUM_RX_CLOCKS];
+	uint32_t	tx_path_clks[NUM_TX_CLOCKS];
+	uint32_t	clk_rate[TX_SAMPL_CLK - BBPLL_CLK + 1];
+	uint32_t	clk_mult[TX_SAMPL_CLK - BBPLL_CLK + 1];
+	uint32_t	clk_div[TX_SAMPL_CLK - BBPLL_CLK + 1];
+	/* Register images */
+	uint8_t		cp_current;
+	uint8_t		bb_freq_word[4];
+	uint8_t		bbpll;
+	uint8_t		filter_ctrl[2];
+};
+
+struct ad9361_rate_plan_cache {
+	struct ad9361_rate_plan	plan[AD9361_RATE_PLAN_CACHE_SIZE];
+	uint32_t		use_count;
+	uint32_t		hits;
+	uint32_t		misses;
+};
+
+/* Gain table bands whose SPI image is kept, see ad9361_adi_gt_info */
+#define AD9361_GT_IMAGE_CACHE_SIZE	6
+
+struct spi_msg;
+
+/**
+ * @struct ad9361_spi_image
+ * @brief Register writes assembled into one SPI message, one segment per
+ * multi-register write instruction.
+ */
+struct ad9361_spi_image {
+	uint8_t		*buf;
+	struct spi_msg	*msgs;
+	uint32_t	nb_msgs;
+};
+
+struct ad9361_gt_image {
+	struct ad9361_spi_image	spi;
+	uint32_t		dest;
+	uint8_t			lna;
+	int32_t			tx_quad_lpf_tia_match;
+};
+
+#define AD9361_DIG_TUNE_DB_SIZE		8
+
+struct ad9361_dig_tune_entry {
+	uint32_t	board_id;
+	/* RX_SAMPL_CLK rate, or the highest swept rate if max_freq is set */
+	uint32_t	rate;
+	uint32_t	max_freq;
+	bool		tx;
+	uint8_t		clk_delay;
+	uint8_t		data_delay;
+	/* Failing delays of the sweep, bit j of line i is field[i][j] */
+	uint16_t	fail_map[2];
+};
+
+struct ad9361_dig_tune_db {
+	struct ad9361_dig_tune_entry	entry[AD9361_DIG_TUNE_DB_SIZE];
+	uint8_t				count;
+	uint8_t				next;
+};
+
+/**
+ * @struct ad9361_dig_tune_store
+ * @brief Non-volatile storage for the digital interface tuning database
+ * (EEPROM, flash, file). load() returns the number of bytes read and save()
+ * 0, both return a negative error code on failure.
+ */
+struct ad9361_dig_tune_store {
+	int32_t	(*load)(void *ctx, uint8_t *buf, uint32_t len);
+	int32_t	(*save)(void *ctx, const uint8_t *buf, uint32_t len);
+	void	*ctx;
+};
+
 enum dig_tune_flags {
 	BE_VERBOSE = 1,
 	BE_MOREVERBOSE = 2,
@@ -3366,6 +3459,7 @@ struct ad9361_rf_phy {
 	int32_t			tx_quad_lpf_tia_match;
 	uint32_t		current_table;
 	struct gain_table_info  *gt_info;
+	struct ad9361_gt_image	gt_image[AD9361_GT_IMAGE_CACHE_SIZE];
 	bool 			ensm_pin_ctl_en;
 
 	bool			auto_cal_en;
@@ -3406,6 +3500,10 @@ struct ad9361_rf_phy {
 	uint32_t 			tx1_atten_cached;
 	uint32_t 			tx2_atten_cached;
 	struct ad9361_fastlock	fastlock;
+	struct ad9361_rate_plan_cache	rate_plans;
+	uint32_t		dig_tune_board_id;
+	struct ad9361_dig_tune_store	*dig_tune_store;
+	struct ad9361_dig_tune_db	dig_tune_db;
 	struct axiadc_converter	*adc_conv;
 	struct axiadc_state		*adc_state;
 	int32_t					bist_loopback_mode;
@@ -3544,12 +3642,17 @@ void ad9361_ensm_restore_state(struct ad9361_rf_phy *phy, uint8_t ensm_state);
 void ad9361_ensm_restore_prev_state(struct ad9361_rf_phy *phy);
 int32_t ad9361_set_trx_clock_chain_freq(struct ad9361_rf_phy *phy,
 					uint32_t freq);
+void ad9361_rate_plan_flush(struct ad9361_rf_phy *phy);
 int32_t ad9361_find_opt(uint8_t *field, uint32_t size, uint32_t *ret_start);
 int32_t ad9361_hdl_loopback(struct ad9361_rf_phy *phy, bool enable);
 int32_t ad9361_dig_interface_timing_analysis(struct ad9361_rf_phy *phy,
 		char *buf, int32_t buflen);
 int32_t ad9361_dig_tune(struct ad9361_rf_phy *phy, uint32_t max_freq,
 			enum dig_tune_flags flags);
+void ad9361_gt_image_flush(struct ad9361_rf_phy *phy);
+int32_t ad9361_dig_tune_db_load(struct ad9361_rf_phy *phy);
+int32_t ad9361_dig_tune_db_save(struct ad9361_rf_phy *phy);
+void ad9361_dig_tune_db_clear(struct ad9361_rf_phy *phy);
 int32_t ad9361_en_dis_tx(struct ad9361_rf_phy *phy, uint32_t tx_if,
 			 uint32_t enable);
 int32_t ad9361_en_dis_rx(struct ad9361_rf_phy *phy, uint32_t rx_if,
@@ -543,6 +543,10 @@ int32_t ad9361_init (struct ad9361_rf_phy **ad9361_phy,
 	phy->ad9361_rfpll_ext_round_rate = init_param->ad9361_rfpll_ext_round_rate;
 	phy->ad9361_rfpll_ext_set_rate = init_param->ad9361_rfpll_ext_set_rate;
 
+	phy->dig_tune_board_id = init_param->dig_tune_board_id;
+	phy->dig_tune_store = init_param->dig_tune_store;
+	ad9361_dig_tune_db_load(phy);
+
 	ret = ad9361_register_clocks(phy);
 	if (ret < 0)
 		goto out;
@@ -569,6 +573,7 @@ int32_t ad9361_init (struct ad9361_rf_phy **ad9361_phy,
 out_clk:
 	ad9361_unregister_clocks(phy);
 out:
+	ad9361_gt_image_flush(phy);
 #ifndef AXI_ADC_NOT_PRESENT
 	free(phy->adc_conv);
 	free(phy->adc_state);
@@ -588,6 +593,7 @@ out:
  */
 int32_t ad9361_remove(struct ad9361_rf_phy *phy)
 {
+	ad9361_gt_image_flush(phy);
 	ad9361_unregister_clocks(phy);
 	spi_remove(phy->spi);
 	gpio_remove(phy->gpio_desc_resetb);
@@ -827,15 +833,11 @@ int32_t ad9361_set_rx_sampling_freq (struct ad9361_rf_phy *phy,
 				     uint32_t sampling_freq_hz)
 {
 	int32_t ret;
-	uint32_t rx[6], tx[6];
 
-	ret = ad9361_calculate_rf_clock_chain(phy, sampling_freq_hz,
-					      phy->rate_governor, rx, tx);
+	ret = ad9361_set_trx_clock_chain_freq(phy, sampling_freq_hz);
 	if (ret < 0)
 		return ret;
 
-	ad9361_set_trx_clock_chain(phy, rx, tx);
-
 	ret = ad9361_update_rf_bandwidth(phy, phy->current_rx_bw_Hz,
 					 phy->current_tx_bw_Hz);
 
@@ -1467,21 +1469,37 @@ int32_t ad9361_set_tx_sampling_freq (struct ad9361_rf_phy *phy,
 				     uint32_t sampling_freq_hz)
 {
 	int32_t ret;
-	uint32_t rx[6], tx[6];
 
-	ret = ad9361_calculate_rf_clock_chain(phy, sampling_freq_hz,
-					      phy->rate_governor, rx, tx);
+	ret = ad9361_set_trx_clock_chain_freq(phy, sampling_freq_hz);
 	if (ret < 0)
 		return ret;
 
-	ad9361_set_trx_clock_chain(phy, rx, tx);
-
 	ret = ad9361_update_rf_bandwidth(phy, phy->current_rx_bw_Hz,
 					 phy->current_tx_bw_Hz);
 
 	return ret;
 }
 
+/**
+ * Get the sample rate plan cache statistics.
+ * @param phy The AD9361 current state structure.
+ * @param hits A variable to store the number of rate changes served from
+ *             the cache.
+ * @param misses A variable to store the number of rate changes that needed
+ *               the full clock chain calculation.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_get_rate_plan_stats(struct ad9361_rf_phy *phy,
+				   uint32_t *hits, uint32_t *misses)
+{
+	if (hits)
+		*hits = phy->rate_plans.hits;
+	if (misses)
+		*misses = phy->rate_plans.misses;
+
+	return 0;
+}
+
 /**
  * Get current TX sampling frequency.
  * @param phy The AD9361 current state structure.
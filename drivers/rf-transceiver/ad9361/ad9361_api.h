@@ -297,6 +297,9 @@ typedef struct {
 	struct axi_adc_init	*rx_adc_init;
 	struct axi_dac_init	*tx_dac_init;
 #endif
+	/* Digital interface tuning database */
+	uint32_t	dig_tune_board_id;	/* board or serial number */
+	struct ad9361_dig_tune_store	*dig_tune_store;
 } AD9361_InitParam;
 
 typedef struct {
@@ -478,6 +481,9 @@ int32_t ad9361_set_tx_sampling_freq (struct ad9361_rf_phy *phy,
 /* Get current TX sampling frequency. */
 int32_t ad9361_get_tx_sampling_freq (struct ad9361_rf_phy *phy,
 				     uint32_t *sampling_freq_hz);
+/* Get the sample rate plan cache statistics. */
+int32_t ad9361_get_rate_plan_stats(struct ad9361_rf_phy *phy,
+				   uint32_t *hits, uint32_t *misses);
 /* Set the TX LO frequency. */
 int32_t ad9361_set_tx_lo_freq (struct ad9361_rf_phy *phy, uint64_t lo_freq_hz);
 /* Get current TX LO frequency. */
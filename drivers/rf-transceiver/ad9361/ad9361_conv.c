@@ -46,10 +46,9 @@
 #include "delay.h"
 #include "ad9361_util.h"
 #include "axi_adc_core.h"
+#include "crc8.h"
 #include "app_config.h"
 
-#ifndef AXI_ADC_NOT_PRESENT
-
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
@@ -60,6 +59,169 @@
 #define PCORE_VERSION_MINOR(version)	((version >> 8) & 0xff)
 #define PCORE_VERSION_LETTER(version)	(version & 0xff)
 
+#define AD9361_DIG_TUNE_DB_MAGIC	0x54443936 /* "69DT" */
+#define AD9361_DIG_TUNE_DB_VERSION	1
+#define AD9361_DIG_TUNE_DB_HDR_SIZE	6
+#define AD9361_DIG_TUNE_DB_ENTRY_SIZE	18
+#define AD9361_DIG_TUNE_DB_MAX_SIZE	(AD9361_DIG_TUNE_DB_HDR_SIZE + \
+		AD9361_DIG_TUNE_DB_SIZE * AD9361_DIG_TUNE_DB_ENTRY_SIZE + 1)
+#define AD9361_DIG_TUNE_CRC8_POLY	0x07
+/* PN check time of the stored setting, its neighbours use the sweep time */
+#define AD9361_DIG_TUNE_VERIFY_MS	10
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+DECLARE_CRC8_SLICE_TABLE(ad9361_dig_tune_crc8_table,
+			 AD9361_DIG_TUNE_CRC8_POLY);
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * Compute the CRC of a serialized tuning database.
+ * @param buf The serialized database.
+ * @param len The number of bytes to cover.
+ * @return The CRC8 value.
+ */
+static uint8_t ad9361_dig_tune_db_crc(const uint8_t *buf, uint32_t len)
+{
+	return crc8_slice(ad9361_dig_tune_crc8_table, buf, len, 0);
+}
+
+/**
+ * Store a 32 bit value in little endian byte order.
+ * @param buf The destination.
+ * @param val The value.
+ * @return None.
+ */
+static void ad9361_dig_tune_put_le32(uint8_t *buf, uint32_t val)
+{
+	buf[0] = val;
+	buf[1] = val >> 8;
+	buf[2] = val >> 16;
+	buf[3] = val >> 24;
+}
+
+/**
+ * Load a 32 bit little endian value.
+ * @param buf The source.
+ * @return The value.
+ */
+static uint32_t ad9361_dig_tune_get_le32(const uint8_t *buf)
+{
+	return buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+/**
+ * Forget all the digital interface tuning results.
+ * @param phy The AD9361 state structure.
+ * @return None.
+ */
+void ad9361_dig_tune_db_clear(struct ad9361_rf_phy *phy)
+{
+	memset(&phy->dig_tune_db, 0, sizeof(phy->dig_tune_db));
+}
+
+/**
+ * Load the digital interface tuning database from the non-volatile store.
+ * A missing, corrupted or incompatible image leaves the database empty, so
+ * the interface is simply tuned again.
+ * @param phy The AD9361 state structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_dig_tune_db_load(struct ad9361_rf_phy *phy)
+{
+	struct ad9361_dig_tune_db *db = &phy->dig_tune_db;
+	struct ad9361_dig_tune_entry *e;
+	uint8_t buf[AD9361_DIG_TUNE_DB_MAX_SIZE];
+	uint8_t *p;
+	uint32_t len, i;
+	int32_t ret;
+
+	ad9361_dig_tune_db_clear(phy);
+
+	if (!phy->dig_tune_store || !phy->dig_tune_store->load)
+		return -ENODEV;
+
+	ret = phy->dig_tune_store->load(phy->dig_tune_store->ctx, buf,
+					sizeof(buf));
+	if (ret < 0)
+		return ret;
+	if (ret < AD9361_DIG_TUNE_DB_HDR_SIZE + 1)
+		return -EINVAL;
+
+	if (ad9361_dig_tune_get_le32(buf) != AD9361_DIG_TUNE_DB_MAGIC ||
+	    buf[4] != AD9361_DIG_TUNE_DB_VERSION ||
+	    buf[5] > AD9361_DIG_TUNE_DB_SIZE)
+		return -EINVAL;
+
+	len = AD9361_DIG_TUNE_DB_HDR_SIZE + buf[5] * AD9361_DIG_TUNE_DB_ENTRY_SIZE;
+	if ((uint32_t)ret < len + 1 ||
+	    ad9361_dig_tune_db_crc(buf, len) != buf[len])
+		return -EINVAL;
+
+	for (i = 0, p = &buf[AD9361_DIG_TUNE_DB_HDR_SIZE]; i < buf[5];
+	     i++, p += AD9361_DIG_TUNE_DB_ENTRY_SIZE) {
+		e = &db->entry[i];
+		e->board_id = ad9361_dig_tune_get_le32(&p[0]);
+		e->rate = ad9361_dig_tune_get_le32(&p[4]);
+		e->max_freq = ad9361_dig_tune_get_le32(&p[8]);
+		e->tx = p[12] & 1;
+		e->clk_delay = p[13] >> 4;
+		e->data_delay = p[13] & 0xF;
+		e->fail_map[0] = p[14] | (p[15] << 8);
+		e->fail_map[1] = p[16] | (p[17] << 8);
+	}
+	db->count = buf[5];
+	db->next = db->count % AD9361_DIG_TUNE_DB_SIZE;
+
+	return 0;
+}
+
+/**
+ * Write the digital interface tuning database to the non-volatile store.
+ * @param phy The AD9361 state structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_dig_tune_db_save(struct ad9361_rf_phy *phy)
+{
+	struct ad9361_dig_tune_db *db = &phy->dig_tune_db;
+	struct ad9361_dig_tune_entry *e;
+	uint8_t buf[AD9361_DIG_TUNE_DB_MAX_SIZE];
+	uint8_t *p;
+	uint32_t len, i;
+
+	if (!phy->dig_tune_store || !phy->dig_tune_store->save)
+		return -ENODEV;
+
+	ad9361_dig_tune_put_le32(buf, AD9361_DIG_TUNE_DB_MAGIC);
+	buf[4] = AD9361_DIG_TUNE_DB_VERSION;
+	buf[5] = db->count;
+
+	for (i = 0, p = &buf[AD9361_DIG_TUNE_DB_HDR_SIZE]; i < db->count;
+	     i++, p += AD9361_DIG_TUNE_DB_ENTRY_SIZE) {
+		e = &db->entry[i];
+		ad9361_dig_tune_put_le32(&p[0], e->board_id);
+		ad9361_dig_tune_put_le32(&p[4], e->rate);
+		ad9361_dig_tune_put_le32(&p[8], e->max_freq);
+		p[12] = e->tx;
+		p[13] = (e->clk_delay << 4) | e->data_delay;
+		p[14] = e->fail_map[0];
+		p[15] = e->fail_map[0] >> 8;
+		p[16] = e->fail_map[1];
+		p[17] = e->fail_map[1] >> 8;
+	}
+
+	len = AD9361_DIG_TUNE_DB_HDR_SIZE + db->count * AD9361_DIG_TUNE_DB_ENTRY_SIZE;
+	buf[len] = ad9361_dig_tune_db_crc(buf, len);
+
+	return phy->dig_tune_store->save(phy->dig_tune_store->ctx, buf, len + 1);
+}
+
+#ifndef AXI_ADC_NOT_PRESENT
+
 /**
  * Get the number of PHY channels.
  * @return The number of PHY channels.
@@ -288,13 +450,25 @@ static void ad9361_set_intf_delay(struct ad9361_rf_phy *phy, bool tx,
 int32_t ad9361_dig_interface_timing_analysis(struct ad9361_rf_phy *phy,
 	char *buf, int32_t buflen)
 {
-	uint32_t loopback, bist, ensm_state;
+	struct ad9361_dig_tune_entry *e = NULL;
+	uint32_t loopback, bist, ensm_state, rate;
 	int32_t i, j, len = 0;
 	uint8_t field[16][16];
 	uint8_t rx;
 
 	dev_dbg(&phy->spi->dev, "%s:\n", __func__);
 
+	/* Stored RX tuning result at this rate, from boot or a rate change */
+	rate = clk_get_rate(phy, phy->ref_clk_scale[RX_SAMPL_CLK]);
+	for (i = 0; i < phy->dig_tune_db.count; i++) {
+		if (phy->dig_tune_db.entry[i].board_id == phy->dig_tune_board_id &&
+		    phy->dig_tune_db.entry[i].rate == rate &&
+		    !phy->dig_tune_db.entry[i].tx) {
+			e = &phy->dig_tune_db.entry[i];
+			break;
+		}
+	}
+
 	loopback = phy->bist_loopback_mode;
 	bist = phy->bist_config;
 	ensm_state = ad9361_ensm_get_state(phy);
@@ -328,7 +502,11 @@ int32_t ad9361_dig_interface_timing_analysis(struct ad9361_rf_phy *phy,
 	ad9361_tx_mute(phy, 0);
 
 	len += snprintf(buf + len, buflen, "CLK: %"PRIu32" Hz 'o' = PASS\n",
-		clk_get_rate(phy, phy->ref_clk_scale[RX_SAMPL_CLK]));
+		rate);
+	if (e)
+		len += snprintf(buf + len, buflen,
+				"Stored: CLK %d DATA %d 'O' = PASS '*' = FAIL\n",
+				e->clk_delay, e->data_delay);
 	len += snprintf(buf + len, buflen, "DC");
 	for (i = 0; i < 16; i++)
 		len += snprintf(buf + len, buflen, "%"PRIx32":", i);
@@ -337,8 +515,12 @@ int32_t ad9361_dig_interface_timing_analysis(struct ad9361_rf_phy *phy,
 	for (i = 0; i < 16; i++) {
 		len += snprintf(buf + len, buflen, "%"PRIx32":", i);
 		for (j = 0; j < 16; j++) {
-			len += snprintf(buf + len, buflen, "%c ",
-				(field[i][j] ? '.' : 'o'));
+			if (e && i == e->data_delay && j == e->clk_delay)
+				len += snprintf(buf + len, buflen, "%c ",
+					(field[i][j] ? '*' : 'O'));
+			else
+				len += snprintf(buf + len, buflen, "%c ",
+					(field[i][j] ? '.' : 'o'));
 		}
 		len += snprintf(buf + len, buflen, "\n");
 	}
@@ -347,6 +529,110 @@ int32_t ad9361_dig_interface_timing_analysis(struct ad9361_rf_phy *phy,
 	return len;
 }
 
+/**
+ * Find the tuning result of this board for a given rate.
+ * @param phy The AD9361 state structure.
+ * @param rate The sample rate, see struct ad9361_dig_tune_entry.
+ * @param max_freq The max_freq the tuning was requested with.
+ * @param tx Set if TX.
+ * @return The entry or NULL if the interface was never tuned for it.
+ */
+static struct ad9361_dig_tune_entry *ad9361_dig_tune_db_find(
+	struct ad9361_rf_phy *phy, uint32_t rate, uint32_t max_freq, bool tx)
+{
+	struct ad9361_dig_tune_db *db = &phy->dig_tune_db;
+	uint32_t i;
+
+	for (i = 0; i < db->count; i++)
+		if (db->entry[i].board_id == phy->dig_tune_board_id &&
+		    db->entry[i].rate == rate &&
+		    db->entry[i].max_freq == max_freq &&
+		    db->entry[i].tx == tx)
+			return &db->entry[i];
+
+	return NULL;
+}
+
+/**
+ * Record a tuning result and write the database back to the store.
+ * @param phy The AD9361 state structure.
+ * @param rate The sample rate, see struct ad9361_dig_tune_entry.
+ * @param max_freq The max_freq the tuning was requested with.
+ * @param tx Set if TX.
+ * @param clk_delay The selected clock delay.
+ * @param data_delay The selected data delay.
+ * @param field The sweep result.
+ * @return None.
+ */
+static void ad9361_dig_tune_db_update(struct ad9361_rf_phy *phy,
+				      uint32_t rate, uint32_t max_freq,
+				      bool tx, uint32_t clk_delay,
+				      uint32_t data_delay, uint8_t field[][16])
+{
+	struct ad9361_dig_tune_db *db = &phy->dig_tune_db;
+	struct ad9361_dig_tune_entry *e;
+	uint32_t i, j;
+
+	e = ad9361_dig_tune_db_find(phy, rate, max_freq, tx);
+	if (!e) {
+		e = &db->entry[db->next];
+		db->next = (db->next + 1) % AD9361_DIG_TUNE_DB_SIZE;
+		if (db->count < AD9361_DIG_TUNE_DB_SIZE)
+			db->count++;
+	}
+
+	e->board_id = phy->dig_tune_board_id;
+	e->rate = rate;
+	e->max_freq = max_freq;
+	e->tx = tx;
+	e->clk_delay = clk_delay;
+	e->data_delay = data_delay;
+	for (i = 0; i < 2; i++) {
+		e->fail_map[i] = 0;
+		for (j = 0; j < 16; j++)
+			if (field[i][j])
+				e->fail_map[i] |= BIT(j);
+	}
+
+	ad9361_dig_tune_db_save(phy);
+}
+
+/**
+ * Check that a stored tuning result still works: the stored setting and
+ * its neighbours on the sweep line must all pass the PN check, so that a
+ * shrinking timing margin also triggers a new tuning.
+ * @param phy The AD9361 state structure.
+ * @param e The stored tuning result.
+ * @return true if the stored setting can be used, false otherwise.
+ */
+static bool ad9361_dig_tune_db_verify(struct ad9361_rf_phy *phy,
+				      struct ad9361_dig_tune_entry *e)
+{
+	int32_t clk = e->clk_delay, data = e->data_delay;
+	bool first = true;
+	int32_t d;
+
+	for (d = -1; d <= 1; d++) {
+		if (e->clk_delay) {
+			if (clk + d < 0 || clk + d > 15)
+				continue;
+			ad9361_set_intf_delay(phy, e->tx, clk + d, 0, true);
+		} else {
+			if (data + d < 0 || data + d > 15)
+				continue;
+			ad9361_set_intf_delay(phy, e->tx, 0, data + d, first);
+		}
+		first = false;
+		if (ad9361_check_pn(phy, e->tx,
+				    d ? 4 : AD9361_DIG_TUNE_VERIFY_MS))
+			return false;
+	}
+
+	ad9361_set_intf_delay(phy, e->tx, e->clk_delay, e->data_delay, true);
+
+	return true;
+}
+
 /**
  * Digital tune delay.
  * @param phy The AD9361 state structure.
@@ -359,8 +645,9 @@ static int32_t ad9361_dig_tune_delay(struct ad9361_rf_phy *phy,
 		uint32_t max_freq, enum dig_tune_flags flags, bool tx)
 {
 	static const uint32_t rates[3] = {25000000U, 40000000U, 61440000U};
+	struct ad9361_dig_tune_entry *e;
 	uint32_t s0, s1, c0, c1;
-	uint32_t i, j, r;
+	uint32_t i, j, r, rate;
 	bool half_data_rate;
 	uint8_t field[2][16];
 
@@ -370,6 +657,23 @@ static int32_t ad9361_dig_tune_delay(struct ad9361_rf_phy *phy,
 	else
 	    half_data_rate = true;
 
+	if (max_freq)
+		rate = half_data_rate ? rates[ARRAY_SIZE(rates) - 1] / 2 :
+		       rates[ARRAY_SIZE(rates) - 1];
+	else
+		rate = clk_get_rate(phy, phy->ref_clk_scale[RX_SAMPL_CLK]);
+
+	/* Reuse the stored result, the sweep leaves the highest rate set */
+	e = ad9361_dig_tune_db_find(phy, rate, max_freq, tx);
+	if (e) {
+		if (max_freq)
+			ad9361_set_trx_clock_chain_freq(phy, rate);
+		if (ad9361_dig_tune_db_verify(phy, e))
+			return 0;
+		dev_dbg(&phy->spi->dev, "%s: Stored %s tuning failed, retuning",
+			__func__, tx ? "TX" : "RX");
+	}
+
 	memset(field, 0, 32);
 	for (r = 0; r < (max_freq ? ARRAY_SIZE(rates) : 1); r++) {
 		if (max_freq)
@@ -408,10 +712,15 @@ static int32_t ad9361_dig_tune_delay(struct ad9361_rf_phy *phy,
 			ad9361_dig_tune_verbose_print(phy, field, tx, -1, (s0 + c0 / 2));
 	}
 
-	if (c1 > c0)
+	if (c1 > c0) {
 		ad9361_set_intf_delay(phy, tx, s1 + c1 / 2, 0, true);
-	else
+		ad9361_dig_tune_db_update(phy, rate, max_freq, tx,
+					  s1 + c1 / 2, 0, field);
+	} else {
 		ad9361_set_intf_delay(phy, tx, 0, s0 + c0 / 2, true);
+		ad9361_dig_tune_db_update(phy, rate, max_freq, tx,
+					  0, s0 + c0 / 2, field);
+	}
 
 	return 0;
 }
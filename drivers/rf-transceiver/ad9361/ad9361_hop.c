@@ -0,0 +1,542 @@
+/***************************************************************************//**
+ *   @file   ad9361_hop.c
+ *   @brief  Implementation of the AD9361 fastlock frequency hopping scheduler.
+ *   @author Mihail Chindris (mihail.chindris@analog.com)
+********************************************************************************
+ *   @copyright
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "ad9361_hop.h"
+#include "ad9361_util.h"
+#include "timer.h"
+#include "util.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Advance the scheduler time by the timer ticks elapsed since the
+ * last call. Works with up and down counters, as long as it is called more
+ * often than half the timer period.
+ * @param desc - The scheduler descriptor.
+ * @return None.
+ */
+static void ad9361_hop_update_time(struct ad9361_hop_desc *desc)
+{
+	uint64_t period, forward;
+	uint32_t counter;
+
+	if (!desc->timer)
+		return;
+
+	if (desc->timer_counter_get(desc->timer, &counter))
+		return;
+
+	period = desc->timer->load_value ?
+		 (uint64_t)desc->timer->load_value + 1 : 0x100000000ull;
+	forward = ((uint64_t)counter + period - desc->last_counter) % period;
+	desc->last_counter = counter;
+
+	desc->now += min(forward, period - forward);
+}
+
+/**
+ * @brief Binary search of a frequency in the profile cache.
+ * @param desc - The scheduler descriptor.
+ * @param tx - TX or RX cache.
+ * @param freq_hz - The LO frequency.
+ * @param pos - Index of the profile, or where it has to be inserted.
+ * @return The profile or NULL if it is not cached.
+ */
+static struct ad9361_hop_profile *ad9361_hop_find(struct ad9361_hop_desc *desc,
+		bool tx, uint64_t freq_hz, uint32_t *pos)
+{
+	struct ad9361_hop_profile **profiles = desc->profiles[tx];
+	uint32_t lo = 0, hi = desc->nb_profiles[tx], mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (profiles[mid]->freq_hz < freq_hz)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (pos)
+		*pos = lo;
+
+	if (lo < desc->nb_profiles[tx] && profiles[lo]->freq_hz == freq_hz)
+		return profiles[lo];
+
+	return NULL;
+}
+
+/**
+ * @brief Add a profile to the cache, growing it as needed.
+ * @param desc - The scheduler descriptor.
+ * @param tx - TX or RX cache.
+ * @param profile - The new profile.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_hop_insert(struct ad9361_hop_desc *desc, bool tx,
+				 struct ad9361_hop_profile *profile)
+{
+	struct ad9361_hop_profile **profiles;
+	uint32_t pos, max;
+
+	if (ad9361_hop_find(desc, tx, profile->freq_hz, &pos))
+		return -EINVAL;
+
+	if (desc->nb_profiles[tx] == desc->max_profiles[tx]) {
+		max = desc->max_profiles[tx] ? desc->max_profiles[tx] * 2 :
+		      AD9361_HOP_NUM_SLOTS;
+		profiles = realloc(desc->profiles[tx], max * sizeof(*profiles));
+		if (!profiles)
+			return -ENOMEM;
+		desc->profiles[tx] = profiles;
+		desc->max_profiles[tx] = max;
+	}
+
+	profiles = desc->profiles[tx];
+	memmove(&profiles[pos + 1], &profiles[pos],
+		(desc->nb_profiles[tx] - pos) * sizeof(*profiles));
+	profiles[pos] = profile;
+	desc->nb_profiles[tx]++;
+
+	return 0;
+}
+
+/**
+ * @brief Pick the hardware slot to load a profile into: a free slot or the
+ * least recently used one. The slot of the active profile and slots marked
+ * in the pinned mask are never picked.
+ * @param desc - The scheduler descriptor.
+ * @param tx - TX or RX synthesizer.
+ * @param pinned - Mask of slots that must be kept.
+ * @return The slot number or -1 if all slots are pinned.
+ */
+static int32_t ad9361_hop_victim(struct ad9361_hop_desc *desc, bool tx,
+				 uint32_t pinned)
+{
+	uint8_t current = desc->phy->fastlock.current_profile[tx];
+	int32_t i, victim = -1;
+
+	if (current)
+		pinned |= BIT(current - 1);
+
+	for (i = 0; i < AD9361_HOP_NUM_SLOTS; i++) {
+		if (pinned & BIT(i))
+			continue;
+		if (!desc->slot[tx][i])
+			return i;
+		if (victim < 0 ||
+		    desc->slot[tx][i]->last_used < desc->slot[tx][victim]->last_used)
+			victim = i;
+	}
+
+	return victim;
+}
+
+/**
+ * @brief Assign a hardware slot to a profile, evicting its previous owner.
+ * @param desc - The scheduler descriptor.
+ * @param tx - TX or RX synthesizer.
+ * @param slot - The hardware slot.
+ * @param profile - The new owner.
+ * @return None.
+ */
+static void ad9361_hop_assign(struct ad9361_hop_desc *desc, bool tx,
+			      int32_t slot, struct ad9361_hop_profile *profile)
+{
+	if (desc->slot[tx][slot])
+		desc->slot[tx][slot]->slot = -1;
+	desc->slot[tx][slot] = profile;
+	profile->slot = slot;
+	profile->last_used = ++desc->use_count;
+}
+
+/**
+ * @brief Load a cached profile into a hardware slot.
+ * @param desc - The scheduler descriptor.
+ * @param tx - TX or RX synthesizer.
+ * @param profile - The profile.
+ * @param pinned - Mask of slots that must be kept.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_hop_stage(struct ad9361_hop_desc *desc, bool tx,
+				struct ad9361_hop_profile *profile,
+				uint32_t pinned)
+{
+	int32_t slot, ret;
+
+	slot = ad9361_hop_victim(desc, tx, pinned);
+	if (slot < 0)
+		return -EBUSY;
+
+	ret = ad9361_fastlock_load(desc->phy, tx, slot, profile->values);
+	if (ret < 0)
+		return ret;
+
+	ad9361_hop_assign(desc, tx, slot, profile);
+
+	return 0;
+}
+
+/**
+ * @brief Tune the synthesizer the slow way and capture the result as a new
+ * cached profile, also left in a hardware slot.
+ * @param desc - The scheduler descriptor.
+ * @param tx - TX or RX synthesizer.
+ * @param freq_hz - The LO frequency.
+ * @param profile - The new profile.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_hop_compute(struct ad9361_hop_desc *desc, bool tx,
+				  uint64_t freq_hz,
+				  struct ad9361_hop_profile **profile)
+{
+	struct ad9361_rf_phy *phy = desc->phy;
+	struct ad9361_hop_profile *p;
+	int32_t slot, ret;
+
+	/* Leaves fastlock mode, so every slot can be reused */
+	ret = clk_set_rate(phy, phy->ref_clk_scale[tx ? TX_RFPLL : RX_RFPLL],
+			   ad9361_to_clk(freq_hz));
+	if (ret < 0)
+		return ret;
+
+	p = calloc(1, sizeof(*p));
+	if (!p)
+		return -ENOMEM;
+
+	p->freq_hz = freq_hz;
+	p->slot = -1;
+	p->rfpll_rate = phy->clks[tx ? TX_RFPLL : RX_RFPLL]->rate;
+	p->rfpll_int_rate = phy->clks[tx ? TX_RFPLL_INT : RX_RFPLL_INT]->rate;
+
+	slot = ad9361_hop_victim(desc, tx, 0);
+	ret = ad9361_fastlock_store(phy, tx, slot);
+	if (ret < 0)
+		goto error;
+	ret = ad9361_fastlock_save(phy, tx, slot, p->values);
+	if (ret < 0)
+		goto error;
+
+	ret = ad9361_hop_insert(desc, tx, p);
+	if (ret < 0)
+		goto error;
+
+	ad9361_hop_assign(desc, tx, slot, p);
+	*profile = p;
+
+	return 0;
+
+error:
+	if (desc->slot[tx][slot])
+		desc->slot[tx][slot]->slot = -1;
+	desc->slot[tx][slot] = NULL;
+	free(p);
+
+	return ret;
+}
+
+/**
+ * @brief Pre-stage the profiles of the next scheduled hops into hardware
+ * slots, in time order, without evicting the profiles of earlier hops.
+ * Frequencies that were never visited can't be prepared in advance since
+ * that needs a synthesizer retune.
+ * @param desc - The scheduler descriptor.
+ * @return None.
+ */
+static void ad9361_hop_prestage(struct ad9361_hop_desc *desc)
+{
+	struct ad9361_hop_profile *p;
+	uint32_t pinned[2] = {0, 0};
+	uint32_t i;
+	bool tx;
+
+	for (i = 0; i < desc->queue_len; i++) {
+		tx = desc->queue[i].tx;
+		p = ad9361_hop_find(desc, tx, desc->queue[i].freq_hz, NULL);
+		if (!p)
+			continue;
+		if (p->slot < 0 && ad9361_hop_stage(desc, tx, p, pinned[tx]))
+			continue;
+		pinned[tx] |= BIT(p->slot);
+	}
+}
+
+/**
+ * @brief Initialize the hop scheduler.
+ * @param desc - The scheduler descriptor.
+ * @param param - The initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_init(struct ad9361_hop_desc **desc,
+			struct ad9361_hop_init_param *param)
+{
+	struct ad9361_hop_desc *ldesc;
+
+	if (!desc || !param || !param->phy)
+		return -EINVAL;
+
+	if (param->timer && !param->timer_counter_get)
+		return -EINVAL;
+
+	ldesc = calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return -ENOMEM;
+
+	ldesc->phy = param->phy;
+	ldesc->timer = param->timer;
+	ldesc->timer_counter_get = param->timer_counter_get;
+	if (ldesc->timer)
+		ldesc->timer_counter_get(ldesc->timer, &ldesc->last_counter);
+
+	*desc = ldesc;
+
+	return 0;
+}
+
+/**
+ * @brief Free the resources allocated by ad9361_hop_init().
+ * @param desc - The scheduler descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_remove(struct ad9361_hop_desc *desc)
+{
+	uint32_t i, tx;
+
+	if (!desc)
+		return -EINVAL;
+
+	for (tx = 0; tx < 2; tx++) {
+		for (i = 0; i < desc->nb_profiles[tx]; i++)
+			free(desc->profiles[tx][i]);
+		free(desc->profiles[tx]);
+	}
+	free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Tune to a frequency once and cache its profile. Used to build the
+ * hop set up front, so the scheduled hops never pay a full tuning.
+ * The LO is left at freq_hz.
+ * @param desc - The scheduler descriptor.
+ * @param tx - TX or RX synthesizer.
+ * @param freq_hz - The LO frequency.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_learn(struct ad9361_hop_desc *desc, bool tx,
+			 uint64_t freq_hz)
+{
+	struct ad9361_hop_profile *p;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (ad9361_hop_find(desc, tx, freq_hz, NULL))
+		return 0;
+
+	return ad9361_hop_compute(desc, tx, freq_hz, &p);
+}
+
+/**
+ * @brief Hop to a frequency now. A profile already in a hardware slot is
+ * only recalled, a cached one is first loaded into the least recently used
+ * slot and an unknown frequency is tuned and cached.
+ * @param desc - The scheduler descriptor.
+ * @param tx - TX or RX synthesizer.
+ * @param freq_hz - The LO frequency.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_to(struct ad9361_hop_desc *desc, bool tx,
+		      uint64_t freq_hz)
+{
+	struct ad9361_rf_phy *phy;
+	struct ad9361_hop_profile *p;
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	phy = desc->phy;
+	p = ad9361_hop_find(desc, tx, freq_hz, NULL);
+	if (!p) {
+		desc->stats.misses++;
+		return ad9361_hop_compute(desc, tx, freq_hz, &p);
+	}
+
+	if (p->slot < 0) {
+		desc->stats.cache_hits++;
+		ret = ad9361_hop_stage(desc, tx, p, 0);
+		if (ret < 0)
+			return ret;
+	} else {
+		desc->stats.slot_hits++;
+		p->last_used = ++desc->use_count;
+	}
+
+	ret = ad9361_fastlock_recall(phy, tx, p->slot);
+	if (ret < 0)
+		return ret;
+
+	/* Keep the clock tree in sync with the recalled profile */
+	phy->clks[tx ? TX_RFPLL : RX_RFPLL]->rate = p->rfpll_rate;
+	phy->clks[tx ? TX_RFPLL_INT : RX_RFPLL_INT]->rate = p->rfpll_int_rate;
+
+	return 0;
+}
+
+/**
+ * @brief Schedule a hop to a frequency at a given scheduler time. The hop is
+ * executed by ad9361_hop_process(); its profile is pre-staged right away if
+ * it is cached.
+ * @param desc - The scheduler descriptor.
+ * @param tx - TX or RX synthesizer.
+ * @param freq_hz - The LO frequency.
+ * @param time - Scheduler time of the hop, see ad9361_hop_get_time().
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_schedule(struct ad9361_hop_desc *desc, bool tx,
+			    uint64_t freq_hz, uint64_t time)
+{
+	uint32_t pos;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->queue_len == AD9361_HOP_QUEUE_SIZE)
+		return -EBUSY;
+
+	/* Hops with the same time keep their scheduling order */
+	for (pos = desc->queue_len; pos > 0; pos--) {
+		if (desc->queue[pos - 1].time <= time)
+			break;
+		desc->queue[pos] = desc->queue[pos - 1];
+	}
+	desc->queue[pos].time = time;
+	desc->queue[pos].freq_hz = freq_hz;
+	desc->queue[pos].tx = tx;
+	desc->queue_len++;
+
+	ad9361_hop_prestage(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Execute the scheduled hops that are due and pre-stage the profiles
+ * of the following ones. Must be called often enough for the requested hop
+ * time accuracy, e.g. from the main loop or a timer interrupt.
+ * @param desc - The scheduler descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_process(struct ad9361_hop_desc *desc)
+{
+	struct ad9361_hop_event ev;
+	int32_t ret = 0;
+	uint32_t done = 0;
+
+	if (!desc)
+		return -EINVAL;
+
+	ad9361_hop_update_time(desc);
+
+	while (desc->queue_len) {
+		ev = desc->queue[0];
+		if (desc->timer && ev.time > desc->now)
+			break;
+		if (desc->timer && ev.time < desc->now)
+			desc->stats.late++;
+
+		desc->queue_len--;
+		memmove(&desc->queue[0], &desc->queue[1],
+			desc->queue_len * sizeof(desc->queue[0]));
+
+		ret = ad9361_hop_to(desc, ev.tx, ev.freq_hz);
+		if (ret < 0)
+			break;
+		done++;
+	}
+
+	if (done)
+		ad9361_hop_prestage(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Get the scheduler time: timer ticks since ad9361_hop_init().
+ * @param desc - The scheduler descriptor.
+ * @param now - The scheduler time.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_get_time(struct ad9361_hop_desc *desc, uint64_t *now)
+{
+	if (!desc || !now)
+		return -EINVAL;
+
+	ad9361_hop_update_time(desc);
+	*now = desc->now;
+
+	return 0;
+}
+
+/**
+ * @brief Get the hop counters.
+ * @param desc - The scheduler descriptor.
+ * @param stats - The counters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_get_stats(struct ad9361_hop_desc *desc,
+			     struct ad9361_hop_stats *stats)
+{
+	if (!desc || !stats)
+		return -EINVAL;
+
+	*stats = desc->stats;
+
+	return 0;
+}
@@ -0,0 +1,177 @@
+/***************************************************************************//**
+ *   @file   ad9361_hop.h
+ *   @brief  Header file of the AD9361 fastlock frequency hopping scheduler.
+ *   @author Mihail Chindris (mihail.chindris@analog.com)
+********************************************************************************
+ *   @copyright
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef AD9361_HOP_H_
+#define AD9361_HOP_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad9361.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Number of hardware fastlock profile slots per synthesizer */
+#define AD9361_HOP_NUM_SLOTS	8
+/** Maximum number of scheduled, not yet executed hops */
+#define AD9361_HOP_QUEUE_SIZE	16
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+struct timer_desc;
+
+/**
+ * @struct ad9361_hop_profile
+ * @brief Fastlock profile of one LO frequency, kept in host memory.
+ */
+struct ad9361_hop_profile {
+	/** Requested LO frequency (Hz) */
+	uint64_t	freq_hz;
+	/** RFPLL and RFPLL_INT clock rates the synthesizer was tuned to */
+	uint32_t	rfpll_rate;
+	uint32_t	rfpll_int_rate;
+	/** Fastlock profile words, as read by ad9361_fastlock_save() */
+	uint8_t		values[RX_FAST_LOCK_CONFIG_WORD_NUM];
+	/** Hardware slot holding the profile or -1 */
+	int8_t		slot;
+	/** LRU stamp of the hardware slot */
+	uint32_t	last_used;
+};
+
+/**
+ * @struct ad9361_hop_event
+ * @brief Scheduled hop.
+ */
+struct ad9361_hop_event {
+	/** Scheduler time (timer ticks) at which to hop */
+	uint64_t	time;
+	/** Target LO frequency (Hz) */
+	uint64_t	freq_hz;
+	/** TX or RX synthesizer */
+	bool		tx;
+};
+
+/**
+ * @struct ad9361_hop_stats
+ * @brief Hop counters.
+ */
+struct ad9361_hop_stats {
+	/** Profile was already in a hardware slot: recall only */
+	uint32_t	slot_hits;
+	/** Profile was cached in host memory: slot load and recall */
+	uint32_t	cache_hits;
+	/** Profile had to be computed: full synthesizer tuning */
+	uint32_t	misses;
+	/** Scheduled hops executed after their time */
+	uint32_t	late;
+};
+
+/**
+ * @struct ad9361_hop_init_param
+ * @brief Hop scheduler initialization parameters.
+ */
+struct ad9361_hop_init_param {
+	/** Initialized AD9361 device. The scheduler owns its fastlock slots. */
+	struct ad9361_rf_phy	*phy;
+	/** Optional started timer used as time base for scheduled hops.
+	 *  Without a timer, scheduled hops run on the next process call. */
+	struct timer_desc	*timer;
+	/** Set to timer_counter_get when a timer is used */
+	int32_t (*timer_counter_get)(struct timer_desc *desc, uint32_t *counter);
+};
+
+/**
+ * @struct ad9361_hop_desc
+ * @brief Hop scheduler descriptor.
+ */
+struct ad9361_hop_desc {
+	struct ad9361_rf_phy	*phy;
+	struct timer_desc	*timer;
+	int32_t (*timer_counter_get)(struct timer_desc *desc, uint32_t *counter);
+	/** Last timer counter value and scheduler time */
+	uint32_t		last_counter;
+	uint64_t		now;
+	/** Profile caches sorted by frequency, for RX and TX */
+	struct ad9361_hop_profile	**profiles[2];
+	uint32_t		nb_profiles[2];
+	uint32_t		max_profiles[2];
+	/** Profile held by each hardware slot */
+	struct ad9361_hop_profile	*slot[2][AD9361_HOP_NUM_SLOTS];
+	uint32_t		use_count;
+	/** Scheduled hops sorted by time */
+	struct ad9361_hop_event	queue[AD9361_HOP_QUEUE_SIZE];
+	uint32_t		queue_len;
+	struct ad9361_hop_stats	stats;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the hop scheduler. */
+int32_t ad9361_hop_init(struct ad9361_hop_desc **desc,
+			struct ad9361_hop_init_param *param);
+/* Free the resources allocated by ad9361_hop_init(). */
+int32_t ad9361_hop_remove(struct ad9361_hop_desc *desc);
+/* Tune to a frequency once and cache its profile, without scheduling. */
+int32_t ad9361_hop_learn(struct ad9361_hop_desc *desc, bool tx,
+			 uint64_t freq_hz);
+/* Hop to a frequency now. */
+int32_t ad9361_hop_to(struct ad9361_hop_desc *desc, bool tx,
+		      uint64_t freq_hz);
+/* Schedule a hop to a frequency at a given time. */
+int32_t ad9361_hop_schedule(struct ad9361_hop_desc *desc, bool tx,
+			    uint64_t freq_hz, uint64_t time);
+/* Execute the hops that are due and pre-stage the following ones. */
+int32_t ad9361_hop_process(struct ad9361_hop_desc *desc);
+/* Get the scheduler time, in timer ticks. */
+int32_t ad9361_hop_get_time(struct ad9361_hop_desc *desc, uint64_t *now);
+/* Get the hop counters. */
+int32_t ad9361_hop_get_stats(struct ad9361_hop_desc *desc,
+			     struct ad9361_hop_stats *stats);
+
+#endif /* AD9361_HOP_H_ */
@@ -40,7 +40,13 @@
 #include <inttypes.h>
 #include "spi.h"
 #include <stdlib.h>
+#include <string.h>
 #include "error.h"
+#include "delay.h"
+#include "util.h"
+
+/** Segments up to this size are gathered on the stack by the emulation */
+#define SPI_EMULATED_BUFF_SIZE	64
 
 /**
  * @brief Initialize the SPI communication peripheral.
@@ -85,3 +91,103 @@ int32_t spi_write_and_read(struct spi_desc *desc,
 {
 	return desc->platform_ops->spi_ops_write_and_read(desc, data, bytes_number);
 }
+
+/**
+ * @brief Transfer a message using write and read calls.
+ *
+ * Used for the platforms that do not provide spi_ops_transfer(). Since
+ * spi_ops_write_and_read() handles the chip select by itself, the segments
+ * that share a chip select assertion are gathered in one buffer and sent with
+ * a single call. A segment with a delay also ends the chip select assertion
+ * and cs_change on the last segment is ignored.
+ * @param desc - The SPI descriptor.
+ * @param msgs - Array of message segments.
+ * @param len - Number of segments.
+ * @return SUCCESS in case of success, -EINVAL if the segments under one chip
+ * select assertion are larger than UINT16_MAX bytes, other negative error
+ * code otherwise.
+ */
+static int32_t spi_transfer_emulated(struct spi_desc *desc,
+				     struct spi_msg *msgs,
+				     uint32_t len)
+{
+	uint8_t small_buff[SPI_EMULATED_BUFF_SIZE];
+	uint32_t first, last;
+	uint32_t offset;
+	uint32_t size;
+	uint8_t *buff;
+	uint32_t i;
+	int32_t ret;
+
+	for (first = 0; first < len; first = last + 1) {
+		size = 0;
+		for (last = first; ; last++) {
+			size += msgs[last].bytes_number;
+			if (last == len - 1 || msgs[last].cs_change ||
+			    msgs[last].delay_us)
+				break;
+		}
+		if (size > UINT16_MAX)
+			return -EINVAL;
+
+		if (size) {
+			/* A single segment is transferred in place */
+			if (first == last && msgs[first].rx_buff)
+				buff = msgs[first].rx_buff;
+			else if (size <= sizeof(small_buff))
+				buff = small_buff;
+			else
+				buff = malloc(size);
+			if (!buff)
+				return -ENOMEM;
+
+			for (i = first, offset = 0; i <= last;
+			     offset += msgs[i++].bytes_number) {
+				if (!msgs[i].tx_buff)
+					memset(buff + offset, 0, msgs[i].bytes_number);
+				else if (msgs[i].tx_buff != buff + offset)
+					memcpy(buff + offset, msgs[i].tx_buff,
+					       msgs[i].bytes_number);
+			}
+
+			ret = desc->platform_ops->spi_ops_write_and_read(desc, buff,
+					size);
+
+			for (i = first, offset = 0; !ret && i <= last;
+			     offset += msgs[i++].bytes_number)
+				if (msgs[i].rx_buff && msgs[i].rx_buff != buff + offset)
+					memcpy(msgs[i].rx_buff, buff + offset,
+					       msgs[i].bytes_number);
+
+			if (buff != small_buff && buff != msgs[first].rx_buff)
+				free(buff);
+			if (ret)
+				return ret;
+		}
+
+		if (msgs[last].delay_us)
+			udelay(msgs[last].delay_us);
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Transfer a message made of multiple segments.
+ * @param desc - The SPI descriptor.
+ * @param msgs - Array of message segments.
+ * @param len - Number of segments.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t spi_transfer(struct spi_desc *desc,
+		     struct spi_msg *msgs,
+		     uint32_t len)
+{
+	if (!desc || !msgs || !len)
+		return -EINVAL;
+
+	if (desc->platform_ops->spi_ops_transfer)
+		return desc->platform_ops->spi_ops_transfer(desc, msgs, len);
+
+	return spi_transfer_emulated(desc, msgs, len);
+}
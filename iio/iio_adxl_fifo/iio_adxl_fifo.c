@@ -0,0 +1,248 @@
+/***************************************************************************//**
+ *   @file   iio_adxl_fifo.c
+ *   @brief  Implementation of the iio buffer device of the ADXL FIFO streaming engine
+ *   @author Mihail Chindris (mihail.chindris@analog.com)
+********************************************************************************
+ *   @copyright
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "error.h"
+#include "iio_adxl_fifo.h"
+#include "util.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get a streaming counter.
+ * @param device - Instance of iio_adxl_fifo_desc.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @param priv - Offset of the counter in struct adxl_fifo_stats.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_fifo_stat(void *device, char *buf, size_t len,
+			     const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct iio_adxl_fifo_desc *desc = device;
+	struct adxl_fifo_stats stats;
+	int32_t ret;
+
+	ret = adxl_fifo_get_stats(desc->fifo, &stats);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	return snprintf(buf, len, "%"PRIu32"",
+			*(uint32_t *)((uint8_t *)&stats + priv));
+}
+
+static struct iio_attribute iio_adxl_fifo_buffer_attributes[] = {
+	{
+		.name = "dropped_sets",
+		.priv = offsetof(struct adxl_fifo_stats, dropped_sets),
+		.show = get_fifo_stat,
+	},
+	{
+		.name = "hw_overruns",
+		.priv = offsetof(struct adxl_fifo_stats, hw_overruns),
+		.show = get_fifo_stat,
+	},
+	END_ATTRIBUTES_ARRAY,
+};
+
+/**
+ * @brief Start streaming. The FIFO holds every channel of a set, so only
+ * full masks are accepted.
+ * @param dev - Instance of iio_adxl_fifo_desc.
+ * @param mask - Mask of the channels to be read.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_adxl_fifo_prepare_transfer(void *dev, uint32_t mask)
+{
+	struct iio_adxl_fifo_desc *desc = dev;
+
+	if (mask != desc->all_ch_mask)
+		return -EINVAL;
+
+	if (!desc->fifo->irq_ctrl)
+		return SUCCESS;
+
+	return adxl_fifo_start(desc->fifo);
+}
+
+/**
+ * @brief Stop streaming.
+ * @param dev - Instance of iio_adxl_fifo_desc.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_adxl_fifo_end_transfer(void *dev)
+{
+	struct iio_adxl_fifo_desc *desc = dev;
+
+	return adxl_fifo_stop(desc->fifo);
+}
+
+/**
+ * @brief Read sample sets from the FIFO streaming engine.
+ * @param dev - Instance of iio_adxl_fifo_desc.
+ * @param buff - Where to store the samples.
+ * @param nb_samples - Number of sample sets.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_adxl_fifo_read_dev(void *dev, void *buff,
+				      uint32_t nb_samples)
+{
+	struct iio_adxl_fifo_desc *desc = dev;
+
+	return adxl_fifo_read(desc->fifo, buff,
+			      nb_samples * desc->fifo->set_bytes);
+}
+
+/**
+ * @brief Create the channels of a sample set.
+ * @param desc - Descriptor.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_adxl_fifo_create_device_descriptor(
+	struct iio_adxl_fifo_desc *desc)
+{
+	static const enum iio_modifier modifiers[] = {
+		IIO_MOD_X, IIO_MOD_Y, IIO_MOD_Z
+	};
+	struct iio_channel *ch;
+	uint8_t nb_ch = desc->fifo->set_entries;
+	uint8_t i;
+
+	if (nb_ch > IIO_ADXL_FIFO_MAX_CH)
+		return -EINVAL;
+
+	for (i = 0; i < nb_ch; i++) {
+		ch = &desc->channels[i];
+		ch->scan_index = i;
+		ch->ch_out = false;
+		if (i < ARRAY_SIZE(modifiers)) {
+			ch->ch_type = IIO_ACCEL;
+			ch->modified = true;
+			ch->channel2 = modifiers[i];
+			ch->scan_type = &desc->accel_scan_type;
+		} else {
+			ch->ch_type = IIO_TEMP;
+			ch->scan_type = &desc->temp_scan_type;
+		}
+	}
+	desc->all_ch_mask = (1u << nb_ch) - 1;
+
+	desc->dev_descriptor.num_ch = nb_ch;
+	desc->dev_descriptor.channels = desc->channels;
+	desc->dev_descriptor.buffer_attributes =
+		iio_adxl_fifo_buffer_attributes;
+	desc->dev_descriptor.prepare_transfer = iio_adxl_fifo_prepare_transfer;
+	desc->dev_descriptor.end_transfer = iio_adxl_fifo_end_transfer;
+	desc->dev_descriptor.read_dev = iio_adxl_fifo_read_dev;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the iio device descriptor.
+ * @param desc - Descriptor.
+ * @param dev_descriptor - Where to store the iio device descriptor.
+ */
+void iio_adxl_fifo_get_dev_descriptor(struct iio_adxl_fifo_desc *desc,
+				      struct iio_device **dev_descriptor)
+{
+	*dev_descriptor = &desc->dev_descriptor;
+}
+
+/**
+ * @brief Create an iio buffer device fed by a FIFO streaming engine.
+ *
+ * The descriptor must be registered as the instance of the iio device.
+ * @param desc - Descriptor.
+ * @param param - Configuration structure.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+int32_t iio_adxl_fifo_init(struct iio_adxl_fifo_desc **desc,
+			   struct iio_adxl_fifo_init_param *param)
+{
+	struct iio_adxl_fifo_desc *ldesc;
+	int32_t ret;
+
+	if (!desc || !param || !param->fifo)
+		return -EINVAL;
+
+	ldesc = calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return -ENOMEM;
+
+	ldesc->fifo = param->fifo;
+	ldesc->accel_scan_type = param->accel_scan_type;
+	ldesc->temp_scan_type = param->temp_scan_type;
+
+	ret = iio_adxl_fifo_create_device_descriptor(ldesc);
+	if (IS_ERR_VALUE(ret)) {
+		free(ldesc);
+		return ret;
+	}
+
+	*desc = ldesc;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by iio_adxl_fifo_init().
+ * @param desc - Descriptor.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+int32_t iio_adxl_fifo_remove(struct iio_adxl_fifo_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	free(desc);
+
+	return SUCCESS;
+}
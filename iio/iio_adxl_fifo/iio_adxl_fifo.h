@@ -0,0 +1,110 @@
+/***************************************************************************//**
+ *   @file   iio_adxl_fifo.h
+ *   @brief  Header file of the iio buffer device of the ADXL FIFO streaming engine
+ *   @author Mihail Chindris (mihail.chindris@analog.com)
+********************************************************************************
+ *   @copyright
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef IIO_ADXL_FIFO_H_
+#define IIO_ADXL_FIFO_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "iio_types.h"
+#include "adxl_fifo.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Channels of a sample set: x, y, z and temperature */
+#define IIO_ADXL_FIFO_MAX_CH	4
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_adxl_fifo_desc
+ * @brief iio_adxl_fifo descriptor
+ */
+struct iio_adxl_fifo_desc {
+	/** FIFO streaming engine */
+	struct adxl_fifo *fifo;
+	/** Mask with all the channels of a sample set */
+	uint32_t all_ch_mask;
+	/** Format of the accelerometer channels */
+	struct scan_type accel_scan_type;
+	/** Format of the temperature channel */
+	struct scan_type temp_scan_type;
+	/** Channels of a sample set */
+	struct iio_channel channels[IIO_ADXL_FIFO_MAX_CH];
+	/** iio device descriptor */
+	struct iio_device dev_descriptor;
+};
+
+/**
+ * @struct iio_adxl_fifo_init_param
+ * @brief iio_adxl_fifo configuration
+ */
+struct iio_adxl_fifo_init_param {
+	/** FIFO streaming engine. A sample set is x, y, z and, with a fourth
+	 * entry, temperature, in this order */
+	struct adxl_fifo *fifo;
+	/** Format of the accelerometer FIFO entries */
+	struct scan_type accel_scan_type;
+	/** Format of the temperature FIFO entries, if any */
+	struct scan_type temp_scan_type;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Init iio. */
+int32_t iio_adxl_fifo_init(struct iio_adxl_fifo_desc **desc,
+			   struct iio_adxl_fifo_init_param *param);
+
+/* Get device descriptor. */
+void iio_adxl_fifo_get_dev_descriptor(struct iio_adxl_fifo_desc *desc,
+				      struct iio_device **dev_descriptor);
+
+/* Free the resources allocated by iio_adxl_fifo_init(). */
+int32_t iio_adxl_fifo_remove(struct iio_adxl_fifo_desc *desc);
+
+#endif /* IIO_ADXL_FIFO_H_ */
@@ -56,6 +56,15 @@
 
 #define STORAGE_BITS 16
 
+/* Format of the samples written by the dmac */
+static struct scan_type iio_axi_adc_scan_type = {
+	.sign = 's',
+	.realbits = STORAGE_BITS,
+	.storagebits = STORAGE_BITS,
+	.shift = 0,
+	.is_big_endian = false
+};
+
 /**
  * @brief get_cf_calibphase().
  * @param device - Physical instance of a iio_axi_adc_desc device.
@@ -299,6 +308,42 @@ static ssize_t set_sampling_frequency(void *device, char *buf, size_t len,
 	return -ENOENT;
 }
 
+/**
+ * @brief Get the number of discontinuities detected in continuous capture
+ * mode.
+ * @param device - Physical instance of a iio_axi_adc_desc device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_overflows(void *device, char *buf, size_t len,
+			     const struct iio_ch_info *channel,
+			     intptr_t priv)
+{
+	struct iio_axi_adc_desc *iio_adc = (struct iio_axi_adc_desc *)device;
+
+	return snprintf(buf, len, "%"PRIu32"", iio_adc->overflows);
+}
+
+/**
+ * @brief Reset the number of discontinuities.
+ * @param device - Physical instance of a iio_axi_adc_desc device.
+ * @param buf - Value to be written to attribute.
+ * @param len - Length of the data in "buf".
+ * @param channel - Channel properties.
+ * @return Number of bytes written to device, or negative value on failure.
+ */
+static ssize_t set_overflows(void *device, char *buf, size_t len,
+			     const struct iio_ch_info *channel,
+			     intptr_t priv)
+{
+	struct iio_axi_adc_desc *iio_adc = (struct iio_axi_adc_desc *)device;
+
+	iio_adc->overflows = 0;
+
+	return len;
+}
 
 /**
  * List containing attributes, corresponding to "voltage" channels.
@@ -332,6 +377,166 @@ static struct iio_attribute iio_voltage_attributes[] = {
 	END_ATTRIBUTES_ARRAY
 };
 
+/**
+ * List containing the buffer attributes of the continuous capture mode.
+ */
+static struct iio_attribute iio_continuous_buffer_attributes[] = {
+	{
+		.name = "overflows",
+		.show = get_overflows,
+		.store = set_overflows,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+/**
+ * @brief Stop the continuous capture.
+ * @param iio_adc - Instance of the iio_axi_adc
+ */
+static void iio_axi_adc_stop_capture(struct iio_axi_adc_desc *iio_adc)
+{
+	if (iio_adc->capturing)
+		axi_dmac_abort(iio_adc->dmac);
+	iio_adc->capturing = false;
+}
+
+/**
+ * @brief Start the continuous capture. All the blocks are submitted, so the
+ * DMA keeps filling them while the client reads the oldest one.
+ * @param iio_adc - Instance of the iio_axi_adc
+ * @param block_size - Size of a block in bytes
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_axi_adc_start_capture(struct iio_axi_adc_desc *iio_adc,
+		uint32_t block_size)
+{
+	uint32_t i;
+	int32_t ret;
+
+	iio_axi_adc_stop_capture(iio_adc);
+
+	if ((uint64_t)block_size * iio_adc->nb_blocks >
+	    iio_adc->continuous_buff_size)
+		return -ENOMEM;
+
+	iio_adc->block_size = block_size;
+	iio_adc->rd_block = 0;
+	iio_adc->capturing = true;
+	for (i = 0; i < iio_adc->nb_blocks; i++) {
+		iio_adc->blocks[i].address = iio_adc->continuous_buff +
+					     i * block_size;
+		iio_adc->blocks[i].x_length = block_size;
+		ret = axi_dmac_submit(iio_adc->dmac, &iio_adc->blocks[i]);
+		if (IS_ERR_VALUE(ret)) {
+			iio_axi_adc_stop_capture(iio_adc);
+			return ret;
+		}
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Give the block read by the client back to the DMA and move to the
+ * next one. If the DMA finished all the other blocks in the meantime, it had
+ * nowhere to write and samples were lost.
+ * @param iio_adc - Instance of the iio_axi_adc
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_axi_adc_release_block(struct iio_axi_adc_desc *iio_adc)
+{
+	uint32_t i;
+	bool	 dma_idle;
+
+	axi_dmac_queue_process(iio_adc->dmac);
+	axi_dmac_is_transfer_ready(iio_adc->dmac, &dma_idle);
+	if (dma_idle)
+		iio_adc->overflows++;
+
+	i = iio_adc->rd_block;
+	iio_adc->rd_block = (iio_adc->rd_block + 1) % iio_adc->nb_blocks;
+
+	return axi_dmac_submit(iio_adc->dmac, &iio_adc->blocks[i]);
+}
+
+/**
+ * @brief Make the next captured block available to the client.
+ * Used in continuous capture mode instead of iio_axi_adc_read_dev().
+ * @param dev - Instance of the iio_axi_adc
+ * @param bytes_count - Number of bytes requested by the client
+ * @param ch_mask - Opened channels mask.
+ * @return bytes_count, -ETIMEDOUT if the DMA doesn't fill the block in time
+ * or other negative value in case of error.
+ */
+static ssize_t iio_axi_adc_transfer_dev_to_mem(void *dev, size_t bytes_count,
+		uint32_t ch_mask)
+{
+	struct iio_axi_adc_desc *iio_adc;
+	struct axi_dmac_desc *block;
+	int32_t ret;
+
+	if (!dev)
+		return FAILURE;
+
+	iio_adc = (struct iio_axi_adc_desc *)dev;
+	if (!iio_adc->capturing || bytes_count != iio_adc->block_size)
+		ret = iio_axi_adc_start_capture(iio_adc, bytes_count);
+	else
+		ret = iio_axi_adc_release_block(iio_adc);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	block = &iio_adc->blocks[iio_adc->rd_block];
+	ret = axi_dmac_desc_wait(iio_adc->dmac, block);
+	if (IS_ERR_VALUE(ret)) {
+		/* The DMA dropped the blocks, the next read starts over. */
+		iio_axi_adc_stop_capture(iio_adc);
+		return ret;
+	}
+
+	if (iio_adc->dcache_invalidate_range)
+		iio_adc->dcache_invalidate_range(block->address,
+						 iio_adc->block_size);
+
+	return bytes_count;
+}
+
+/**
+ * @brief Get the address of the data from the block read by the client.
+ * @param dev - Instance of the iio_axi_adc
+ * @param buff - Address of the data
+ * @param offset - Offset in the block
+ * @param bytes_count - Number of bytes to read
+ * @param ch_mask - Opened channels mask.
+ * @return bytes_count or negative value in case of error.
+ */
+static ssize_t iio_axi_adc_get_read_data_ptr(void *dev, void **buff,
+		size_t offset, size_t bytes_count, uint32_t ch_mask)
+{
+	struct iio_axi_adc_desc *iio_adc = (struct iio_axi_adc_desc *)dev;
+
+	if (!iio_adc->capturing)
+		return FAILURE;
+	if (offset + bytes_count > iio_adc->block_size)
+		return -ENOMEM;
+
+	*buff = (void *)(iio_adc->blocks[iio_adc->rd_block].address + offset);
+
+	return bytes_count;
+}
+
+/**
+ * @brief Stop the continuous capture when the client closes the device.
+ * @param dev - Instance of the iio_axi_adc
+ * @return SUCCESS
+ */
+static int32_t iio_axi_adc_end_transfer(void *dev)
+{
+	iio_axi_adc_stop_capture((struct iio_axi_adc_desc *)dev);
+
+	return SUCCESS;
+}
+
 /**
  * @brief Update active channels
  * @param dev - Instance of the iio_axi_adc
@@ -343,6 +548,8 @@ int32_t iio_axi_adc_prepare_transfer(void *dev, uint32_t mask)
 	struct iio_axi_adc_desc *iio_adc = dev;
 
 	iio_adc->mask = mask;
+	if (iio_adc->nb_blocks)
+		iio_axi_adc_stop_capture(iio_adc);
 
 	return axi_adc_update_active_channels(iio_adc->adc, mask);
 }
@@ -363,7 +570,8 @@ int32_t	iio_axi_adc_read_dev(void *dev, void *buff, uint32_t nb_samples)
 		return FAILURE;
 
 	iio_adc = (struct iio_axi_adc_desc *)dev;
-	bytes = nb_samples * hweight8(iio_adc->mask) * (STORAGE_BITS / 8);
+	bytes = sample_conv_bytes(&iio_axi_adc_scan_type,
+				  nb_samples * hweight8(iio_adc->mask));
 
 	iio_adc->dmac->flags = 0;
 	ret = axi_dmac_transfer(iio_adc->dmac, (uint32_t)buff, bytes);
@@ -393,6 +601,9 @@ static ssize_t iio_axi_adc_delete_device_descriptor(
 	if (desc->ch_names)
 		free(desc->ch_names);
 
+	if (desc->blocks)
+		free(desc->blocks);
+
 	return SUCCESS;
 }
 
@@ -406,17 +617,9 @@ static ssize_t iio_axi_adc_delete_device_descriptor(
 static int32_t iio_axi_adc_create_device_descriptor(
 	struct iio_axi_adc_desc *desc, struct iio_device *iio_device)
 {
-	static struct scan_type scan_type = {
-		.sign = 's',
-		.realbits = STORAGE_BITS,
-		.storagebits = STORAGE_BITS,
-		.shift = 0,
-		.is_big_endian = false
-	};
-
 	static struct iio_channel default_channel = {
 		.ch_type = IIO_VOLTAGE,
-		.scan_type =  &scan_type,
+		.scan_type =  &iio_axi_adc_scan_type,
 		.attributes = iio_voltage_attributes,
 		.ch_out = false,
 		.indexed = true,
@@ -446,7 +649,18 @@ static int32_t iio_axi_adc_create_device_descriptor(
 	}
 
 	iio_device->prepare_transfer = iio_axi_adc_prepare_transfer;
-	iio_device->read_dev = iio_axi_adc_read_dev;
+	if (desc->nb_blocks) {
+		desc->blocks = calloc(desc->nb_blocks, sizeof(*desc->blocks));
+		if (!desc->blocks)
+			goto error;
+		iio_device->transfer_dev_to_mem =
+			iio_axi_adc_transfer_dev_to_mem;
+		iio_device->get_read_data_ptr = iio_axi_adc_get_read_data_ptr;
+		iio_device->end_transfer = iio_axi_adc_end_transfer;
+		iio_device->buffer_attributes = iio_continuous_buffer_attributes;
+	} else {
+		iio_device->read_dev = iio_axi_adc_read_dev;
+	}
 
 	return SUCCESS;
 error:
@@ -487,6 +701,9 @@ int32_t iio_axi_adc_init(struct iio_axi_adc_desc **desc,
 	if (!init->rx_adc || !init->rx_dmac)
 		return FAILURE;
 
+	if (init->nb_blocks == 1)
+		return -EINVAL;
+
 	iio_axi_adc_inst = (struct iio_axi_adc_desc *)calloc(1,
 			   sizeof(struct iio_axi_adc_desc));
 	if (!iio_axi_adc_inst)
@@ -496,6 +713,9 @@ int32_t iio_axi_adc_init(struct iio_axi_adc_desc **desc,
 	iio_axi_adc_inst->dmac = init->rx_dmac;
 	iio_axi_adc_inst->dcache_invalidate_range = init->dcache_invalidate_range;
 	iio_axi_adc_inst->get_sampling_frequency = init->get_sampling_frequency;
+	iio_axi_adc_inst->continuous_buff = init->continuous_buff;
+	iio_axi_adc_inst->continuous_buff_size = init->continuous_buff_size;
+	iio_axi_adc_inst->nb_blocks = init->nb_blocks;
 
 	status = iio_axi_adc_create_device_descriptor(iio_axi_adc_inst,
 			&iio_axi_adc_inst->dev_descriptor);
@@ -72,6 +72,22 @@ struct iio_axi_adc_desc {
 	struct iio_device dev_descriptor;
 	/** Channel names */
 	char (*ch_names)[20];
+	/** Memory used by the DMA blocks in continuous capture mode */
+	uint32_t continuous_buff;
+	/** Size of continuous_buff in bytes */
+	uint32_t continuous_buff_size;
+	/** Number of DMA blocks. Continuous capture is used if at least 2 */
+	uint32_t nb_blocks;
+	/** DMA transfer descriptors of the blocks */
+	struct axi_dmac_desc *blocks;
+	/** Size of a block. Set by the first refill after starting capture */
+	uint32_t block_size;
+	/** Block being read by the client */
+	uint32_t rd_block;
+	/** True while the DMA is continuously filling the blocks */
+	bool capturing;
+	/** Number of discontinuities in the captured data */
+	uint32_t overflows;
 };
 
 /**
@@ -88,6 +104,14 @@ struct iio_axi_adc_init_param {
 	/** Custom sampling frequency getter */
 	int (*get_sampling_frequency)(struct axi_adc *dev, uint32_t chan,
 				      uint64_t *sampling_freq_hz);
+	/** Memory for the DMA blocks of the continuous capture mode. It must
+	 * hold nb_blocks buffers of the size requested by the client */
+	uint32_t continuous_buff;
+	/** Size of continuous_buff in bytes */
+	uint32_t continuous_buff_size;
+	/** Number of DMA blocks filled in turn by the DMA in continuous capture
+	 * mode. Set it to 0 to capture a new buffer on each refill instead */
+	uint32_t nb_blocks;
 };
 
 /******************************************************************************/
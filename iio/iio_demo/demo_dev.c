@@ -106,6 +106,34 @@ ssize_t get_demo_attr(void *device, char *buf, size_t len,
 	return -EINVAL;
 }
 
+/**
+ * @brief get_demo_attr_raw().
+ * @param device- Physical instance of a iio_demo_device.
+ * @param val - Where value is stored.
+ * @param channel - Channel properties.
+ * @param priv - Attribute ID
+ * @return SUCCESS in case of success, negative value on failure.
+ */
+int32_t get_demo_attr_raw(void *device, int64_t *val,
+			  const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct iio_demo_desc *desc = device;
+
+	if (channel) {
+		if (priv == DEMO_CHANNEL_ATTR) {
+			*val = desc->dev_ch_attr;
+			return SUCCESS;
+		}
+	} else {
+		if (priv == DEMO_GLOBAL_ATTR) {
+			*val = desc->dev_global_attr;
+			return SUCCESS;
+		}
+	}
+
+	return -EINVAL;
+}
+
 /**
  * @brief set_demo_attr().
  * @param device - Physical instance of a iio_demo_device.
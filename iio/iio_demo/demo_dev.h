@@ -90,6 +90,8 @@ struct iio_demo_init_param {
 
 ssize_t get_demo_attr(void *device, char *buf, size_t len,
 		      const struct iio_ch_info *channel, intptr_t priv);
+int32_t get_demo_attr_raw(void *device, int64_t *val,
+			  const struct iio_ch_info *channel, intptr_t priv);
 ssize_t set_demo_attr(void *device, char *buf, size_t len,
 		      const struct iio_ch_info *channel, intptr_t priv);
 
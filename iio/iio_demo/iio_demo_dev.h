@@ -52,7 +52,8 @@ enum iio_demo_attributes {
 	.name = _name,\
 	.priv = _priv,\
 	.show = get_demo_attr,\
-	.store = set_demo_attr\
+	.store = set_demo_attr,\
+	.show_raw = get_demo_attr_raw\
 }
 
 static struct iio_attribute demo_channel_attributes[] = {
@@ -56,4 +56,12 @@ int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data);
 /* AXI IO Write data */
 int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data);
 
+/* AXI IO Read consecutive registers */
+int32_t axi_io_read_bulk(uint32_t base, uint32_t offset, uint32_t *data,
+			 uint32_t nb_regs);
+
+/* AXI IO Write consecutive registers */
+int32_t axi_io_write_bulk(uint32_t base, uint32_t offset, const uint32_t *data,
+			  uint32_t nb_regs);
+
 #endif // AXI_IO_H_
@@ -63,6 +63,7 @@ struct circular_buffer;
 /******************************************************************************/
 
 int32_t cb_init(struct circular_buffer **desc, uint32_t size);
+int32_t cb_init_spsc(struct circular_buffer **desc, uint32_t size);
 int32_t cb_remove(struct circular_buffer *desc);
 int32_t cb_size(struct circular_buffer *desc, uint32_t *size);
 
@@ -75,6 +76,7 @@ int32_t cb_prepare_async_write(struct circular_buffer *desc,
 			       void **write_buff,
 			       uint32_t *raw_size_avilable);
 int32_t cb_end_async_write(struct circular_buffer *desc);
+int32_t cb_abort_async_write(struct circular_buffer *desc);
 
 int32_t cb_prepare_async_read(struct circular_buffer *desc,
 			      uint32_t raw_size_to_read,
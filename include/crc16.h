@@ -41,14 +41,23 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "crc_table.h"
 
 #define CRC16_TABLE_SIZE 256
 
 #define DECLARE_CRC16_TABLE(_table) \
 	static uint16_t _table[CRC16_TABLE_SIZE]
 
+#define DECLARE_CRC16_CONST_TABLE(_table, _poly) \
+	CRC_DECLARE_TABLE(uint16_t, _table, _poly, 16)
+
+#define DECLARE_CRC16_SLICE_TABLE(_table, _poly) \
+	CRC_DECLARE_SLICE_TABLE(uint16_t, _table, _poly, 16)
+
 void crc16_populate_msb(uint16_t * table, const uint16_t polynomial);
 uint16_t crc16(const uint16_t * table, const uint8_t *pdata, size_t nbytes,
 	       uint16_t crc);
+uint16_t crc16_slice(const uint16_t table[][CRC16_TABLE_SIZE],
+		     const uint8_t *pdata, size_t nbytes, uint16_t crc);
 
 #endif // __CRC16_H
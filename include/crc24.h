@@ -41,14 +41,23 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "crc_table.h"
 
 #define CRC24_TABLE_SIZE 256
 
 #define DECLARE_CRC24_TABLE(_table) \
 	static uint32_t _table[CRC24_TABLE_SIZE]
 
+#define DECLARE_CRC24_CONST_TABLE(_table, _poly) \
+	CRC_DECLARE_TABLE(uint32_t, _table, _poly, 24)
+
+#define DECLARE_CRC24_SLICE_TABLE(_table, _poly) \
+	CRC_DECLARE_SLICE_TABLE(uint32_t, _table, _poly, 24)
+
 void crc24_populate_msb(uint32_t * table, const uint32_t polynomial);
 uint32_t crc24(const uint32_t * table, const uint8_t *pdata, size_t nbytes,
 	       uint32_t crc);
+uint32_t crc24_slice(const uint32_t table[][CRC24_TABLE_SIZE],
+		     const uint8_t *pdata, size_t nbytes, uint32_t crc);
 
 #endif // __CRC24_H
@@ -41,14 +41,23 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "crc_table.h"
 
 #define CRC8_TABLE_SIZE 256
 
 #define DECLARE_CRC8_TABLE(_table) \
 	static uint8_t _table[CRC8_TABLE_SIZE]
 
+#define DECLARE_CRC8_CONST_TABLE(_table, _poly) \
+	CRC_DECLARE_TABLE(uint8_t, _table, _poly, 8)
+
+#define DECLARE_CRC8_SLICE_TABLE(_table, _poly) \
+	CRC_DECLARE_SLICE_TABLE(uint8_t, _table, _poly, 8)
+
 void crc8_populate_msb(uint8_t * table, const uint8_t polynomial);
 uint8_t crc8(const uint8_t * table, const uint8_t *pdata, size_t nbytes,
 	     uint8_t crc);
+uint8_t crc8_slice(const uint8_t table[][CRC8_TABLE_SIZE],
+		   const uint8_t *pdata, size_t nbytes, uint8_t crc);
 
 #endif // __CRC8_H
@@ -0,0 +1,147 @@
+/***************************************************************************//**
+ *   @file   crc_table.h
+ *   @brief  Compile time generation of sliced CRC lookup tables.
+ *   @author Mihail Chindris (mihail.chindris@analog.com)
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef __CRC_TABLE_H
+#define __CRC_TABLE_H
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/*
+ * Number of bytes consumed by one iteration of the crc*_slice() kernels and
+ * number of rows of a sliced table. Slice-by-8 doubles the table size for a
+ * higher throughput on long frames.
+ */
+#ifndef CRC_SLICE_NUM
+#define CRC_SLICE_NUM	4
+#endif
+
+#if (CRC_SLICE_NUM != 4) && (CRC_SLICE_NUM != 8)
+#error "CRC_SLICE_NUM must be 4 or 8"
+#endif
+
+/*
+ * The tables are generated by the preprocessor, so they end up in read only
+ * memory and no populate call is needed at run time.
+ *
+ * An msb-first CRC is linear, so entry n of row k is the xor of the remainders
+ * x^(w + 8 * k + i) mod P for every bit i set in n. These 64 remainders are
+ * computed once per table as enumeration constants, named
+ * <table>_b<k><i>, each one derived from the previous by a single shift.
+ */
+#define CRC_MASK(_w)		((1ul << (_w)) - 1)
+#define CRC_NEXT(_r, _p, _w)	((((_r) << 1) ^ ((((_r) >> ((_w) - 1)) & 1) ? \
+				  (_p) : 0)) & CRC_MASK(_w))
+
+#define CRC_BASIS_ROW(_n, _p, _w, _prev, _k) \
+	_n##_b##_k##0 = CRC_NEXT(_prev, _p, _w), \
+	_n##_b##_k##1 = CRC_NEXT(_n##_b##_k##0, _p, _w), \
+	_n##_b##_k##2 = CRC_NEXT(_n##_b##_k##1, _p, _w), \
+	_n##_b##_k##3 = CRC_NEXT(_n##_b##_k##2, _p, _w), \
+	_n##_b##_k##4 = CRC_NEXT(_n##_b##_k##3, _p, _w), \
+	_n##_b##_k##5 = CRC_NEXT(_n##_b##_k##4, _p, _w), \
+	_n##_b##_k##6 = CRC_NEXT(_n##_b##_k##5, _p, _w), \
+	_n##_b##_k##7 = CRC_NEXT(_n##_b##_k##6, _p, _w)
+
+/* x^(w - 1) is its own remainder and shifting it once more yields P. */
+#define CRC_DECLARE_BASIS(_n, _p, _w) \
+	enum { \
+		_n##_seed = 1ul << ((_w) - 1), \
+		CRC_BASIS_ROW(_n, _p, _w, _n##_seed, 0), \
+		CRC_BASIS_ROW(_n, _p, _w, _n##_b07, 1), \
+		CRC_BASIS_ROW(_n, _p, _w, _n##_b17, 2), \
+		CRC_BASIS_ROW(_n, _p, _w, _n##_b27, 3), \
+		CRC_BASIS_ROW(_n, _p, _w, _n##_b37, 4), \
+		CRC_BASIS_ROW(_n, _p, _w, _n##_b47, 5), \
+		CRC_BASIS_ROW(_n, _p, _w, _n##_b57, 6), \
+		CRC_BASIS_ROW(_n, _p, _w, _n##_b67, 7) \
+	}
+
+#define CRC_ENTRY(_n, _k, _v) \
+	((((_v) & 0x01) ? _n##_b##_k##0 : 0) ^ \
+	 (((_v) & 0x02) ? _n##_b##_k##1 : 0) ^ \
+	 (((_v) & 0x04) ? _n##_b##_k##2 : 0) ^ \
+	 (((_v) & 0x08) ? _n##_b##_k##3 : 0) ^ \
+	 (((_v) & 0x10) ? _n##_b##_k##4 : 0) ^ \
+	 (((_v) & 0x20) ? _n##_b##_k##5 : 0) ^ \
+	 (((_v) & 0x40) ? _n##_b##_k##6 : 0) ^ \
+	 (((_v) & 0x80) ? _n##_b##_k##7 : 0))
+
+#define CRC_ENTRY4(_n, _k, _v) \
+	CRC_ENTRY(_n, _k, (_v)), CRC_ENTRY(_n, _k, (_v) + 1), \
+	CRC_ENTRY(_n, _k, (_v) + 2), CRC_ENTRY(_n, _k, (_v) + 3)
+#define CRC_ENTRY16(_n, _k, _v) \
+	CRC_ENTRY4(_n, _k, (_v)), CRC_ENTRY4(_n, _k, (_v) + 4), \
+	CRC_ENTRY4(_n, _k, (_v) + 8), CRC_ENTRY4(_n, _k, (_v) + 12)
+#define CRC_ENTRY64(_n, _k, _v) \
+	CRC_ENTRY16(_n, _k, (_v)), CRC_ENTRY16(_n, _k, (_v) + 16), \
+	CRC_ENTRY16(_n, _k, (_v) + 32), CRC_ENTRY16(_n, _k, (_v) + 48)
+#define CRC_ROW(_n, _k) { \
+	CRC_ENTRY64(_n, _k, 0), CRC_ENTRY64(_n, _k, 64), \
+	CRC_ENTRY64(_n, _k, 128), CRC_ENTRY64(_n, _k, 192) \
+}
+
+#if CRC_SLICE_NUM == 8
+#define CRC_SLICE_ROWS(_n) { \
+	CRC_ROW(_n, 0), CRC_ROW(_n, 1), CRC_ROW(_n, 2), CRC_ROW(_n, 3), \
+	CRC_ROW(_n, 4), CRC_ROW(_n, 5), CRC_ROW(_n, 6), CRC_ROW(_n, 7) \
+}
+#else
+#define CRC_SLICE_ROWS(_n) { \
+	CRC_ROW(_n, 0), CRC_ROW(_n, 1), CRC_ROW(_n, 2), CRC_ROW(_n, 3) \
+}
+#endif
+
+/*
+ * Define a static single row lookup table, for short frames where the sliced
+ * kernels bring no speed-up.
+ */
+#define CRC_DECLARE_TABLE(_type, _table, _poly, _w) \
+	CRC_DECLARE_BASIS(_table, _poly, _w); \
+	static const _type _table[256] = CRC_ROW(_table, 0)
+
+/*
+ * Define a static sliced lookup table of a given type. Row 0 is the classic
+ * byte-wise table, so it may also be passed to crc8(), crc16() or crc24().
+ */
+#define CRC_DECLARE_SLICE_TABLE(_type, _table, _poly, _w) \
+	CRC_DECLARE_BASIS(_table, _poly, _w); \
+	static const _type _table[CRC_SLICE_NUM][256] = CRC_SLICE_ROWS(_table)
+
+#endif // __CRC_TABLE_H
@@ -103,6 +103,30 @@ enum gpio_values {
 	GPIO_HIGH_Z
 };
 
+/**
+ * @enum gpio_edge
+ * @brief Enum that holds the GPIO edges that can be waited for.
+ */
+enum gpio_edge {
+	/** GPIO rising edge */
+	GPIO_EDGE_RISING = 1,
+	/** GPIO falling edge */
+	GPIO_EDGE_FALLING,
+	/** GPIO rising or falling edge */
+	GPIO_EDGE_BOTH
+};
+
+/**
+ * @struct gpio_event
+ * @brief Structure holding an edge detected on a GPIO.
+ */
+struct gpio_event {
+	/** Detected edge, GPIO_EDGE_RISING or GPIO_EDGE_FALLING */
+	enum gpio_edge	edge;
+	/** Time of the edge in nanoseconds, as provided by the platform */
+	uint64_t	timestamp_ns;
+};
+
 /**
  * @struct gpio_platform_ops
  * @brief Structure holding gpio function pointers that point to the platform
@@ -126,6 +150,20 @@ struct gpio_platform_ops {
 	int32_t (*gpio_ops_set_value)(struct gpio_desc *, uint8_t);
 	/** gpio get value function pointer */
 	int32_t (*gpio_ops_get_value)(struct gpio_desc *, uint8_t *);
+	/** gpio bulk initialization function pointer. Optional, if NULL every
+	 * descriptor is obtained with gpio_ops_get() */
+	int32_t (*gpio_ops_get_bulk)(struct gpio_desc **,
+				     const struct gpio_init_param *, uint32_t);
+	/** gpio bulk set value function pointer. Optional, if NULL every value
+	 * is set with gpio_ops_set_value() */
+	int32_t (*gpio_ops_set_values)(struct gpio_desc **, uint32_t,
+				       const uint8_t *);
+	/** gpio bulk get value function pointer. Optional, if NULL every value
+	 * is read with gpio_ops_get_value() */
+	int32_t (*gpio_ops_get_values)(struct gpio_desc **, uint32_t, uint8_t *);
+	/** gpio wait edge function pointer. Optional */
+	int32_t (*gpio_ops_wait_edge)(struct gpio_desc *, enum gpio_edge,
+				      uint32_t, struct gpio_event *);
 };
 
 /******************************************************************************/
@@ -162,4 +200,25 @@ int32_t gpio_set_value(struct gpio_desc *desc,
 int32_t gpio_get_value(struct gpio_desc *desc,
 		       uint8_t *value);
 
+/* Obtain the descriptors of several GPIOs at once. */
+int32_t gpio_get_bulk(struct gpio_desc **descs,
+		      const struct gpio_init_param *params,
+		      uint32_t nb_gpios);
+
+/* Set the values of several GPIOs. */
+int32_t gpio_set_values(struct gpio_desc **descs,
+			uint32_t nb_gpios,
+			const uint8_t *values);
+
+/* Get the values of several GPIOs. */
+int32_t gpio_get_values(struct gpio_desc **descs,
+			uint32_t nb_gpios,
+			uint8_t *values);
+
+/* Wait for an edge on the specified GPIO. */
+int32_t gpio_wait_edge(struct gpio_desc *desc,
+		       enum gpio_edge edge,
+		       uint32_t timeout_us,
+		       struct gpio_event *event);
+
 #endif // GPIO_H_
@@ -46,6 +46,16 @@
 
 #include <stdint.h>
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** The message reads from the slave device. Otherwise it writes to it */
+#define I2C_MSG_RD	(1 << 0)
+/** Generate a stop condition after the message. The last message of a
+ * transfer always ends with a stop condition */
+#define I2C_MSG_STOP	(1 << 1)
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -87,6 +97,20 @@ typedef struct i2c_desc {
 	void		*extra;
 } i2c_desc;
 
+/**
+ * @struct i2c_transfer_msg
+ * @brief Message of an I2C transfer. The messages of a transfer are separated
+ * by repeated start conditions unless I2C_MSG_STOP is set.
+ */
+struct i2c_transfer_msg {
+	/** Buffer with the data to write, or where the read data is stored */
+	uint8_t		*buff;
+	/** Number of bytes to write/read */
+	uint16_t	bytes_number;
+	/** I2C_MSG_* flags */
+	uint16_t	flags;
+};
+
 /**
  * @struct i2c_platform_ops
  * @brief Structure holding i2c function pointers that point to the platform
@@ -99,6 +123,10 @@ struct i2c_platform_ops {
 	int32_t (*i2c_ops_write)(struct i2c_desc *, uint8_t *, uint8_t, uint8_t);
 	/** i2c write function pointer */
 	int32_t (*i2c_ops_read)(struct i2c_desc *, uint8_t *, uint8_t, uint8_t);
+	/** i2c transfer function pointer. Optional, if NULL the messages are
+	 * issued one by one through i2c_ops_write() and i2c_ops_read() */
+	int32_t (*i2c_ops_transfer)(struct i2c_desc *, struct i2c_transfer_msg *,
+				    uint32_t);
 	/** i2c remove function pointer */
 	int32_t (*i2c_ops_remove)(struct i2c_desc *);
 };
@@ -126,4 +154,9 @@ int32_t i2c_read(struct i2c_desc *desc,
 		 uint8_t bytes_number,
 		 uint8_t stop_bit);
 
+/* Issue several messages to a slave device as one transaction. */
+int32_t i2c_transfer(struct i2c_desc *desc,
+		     struct i2c_transfer_msg *msgs,
+		     uint32_t len);
+
 #endif // I2C_H_
@@ -0,0 +1,125 @@
+/***************************************************************************//**
+ *   @file   regmap.h
+ *   @brief  Register map cache library header
+ *   @author Mihail Chindris (mihail.chindris@analog.com)
+********************************************************************************
+ *   @copyright
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef REGMAP_H
+#define REGMAP_H
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Reference type for register map
+ *
+ * Abstract type of the register map, used as reference for the functions.
+ */
+struct regmap;
+
+/**
+ * @struct regmap_range
+ * @brief Range of register addresses, both ends included
+ */
+struct regmap_range {
+	/** First register of the range */
+	uint32_t	first;
+	/** Last register of the range */
+	uint32_t	last;
+};
+
+/**
+ * @struct regmap_init_param
+ * @brief Register map initialization parameters
+ */
+struct regmap_init_param {
+	/** Highest register address of the device */
+	uint32_t	max_register;
+	/** Registers that are never cached (status, data, self clearing) */
+	const struct regmap_range	*volatile_ranges;
+	/** Number of elements in volatile_ranges */
+	uint32_t	nb_volatile_ranges;
+	/** Maximum number of registers in one bulk transaction. 0 if there is
+	 * no limit */
+	uint32_t	max_burst;
+	/** Device specific context passed to the bus callbacks */
+	void		*ctx;
+	/** Read one register from the device */
+	int32_t (*reg_read)(void *ctx, uint32_t reg, uint32_t *val);
+	/** Write one register of the device */
+	int32_t (*reg_write)(void *ctx, uint32_t reg, uint32_t val);
+	/** Optional. Read count consecutive registers starting at reg in a
+	 * single transaction */
+	int32_t (*reg_read_bulk)(void *ctx, uint32_t reg, uint32_t *vals,
+				 uint32_t count);
+	/** Optional. Write count consecutive registers starting at reg in a
+	 * single transaction */
+	int32_t (*reg_write_bulk)(void *ctx, uint32_t reg, const uint32_t *vals,
+				  uint32_t count);
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+int32_t regmap_init(struct regmap **desc,
+		    const struct regmap_init_param *param);
+int32_t regmap_remove(struct regmap *desc);
+
+int32_t regmap_read(struct regmap *desc, uint32_t reg, uint32_t *val);
+int32_t regmap_write(struct regmap *desc, uint32_t reg, uint32_t val);
+int32_t regmap_update_bits(struct regmap *desc, uint32_t reg, uint32_t mask,
+			   uint32_t val);
+
+int32_t regmap_bulk_read(struct regmap *desc, uint32_t reg, uint32_t *vals,
+			 uint32_t count);
+int32_t regmap_bulk_write(struct regmap *desc, uint32_t reg,
+			  const uint32_t *vals, uint32_t count);
+
+int32_t regmap_cache_only(struct regmap *desc, bool enable);
+int32_t regmap_sync(struct regmap *desc);
+int32_t regmap_invalidate(struct regmap *desc);
+
+#endif
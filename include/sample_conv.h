@@ -0,0 +1,106 @@
+/***************************************************************************//**
+ *   @file   sample_conv.h
+ *   @brief  Sample format conversion library header
+ *   @author Mihail Chindris (mihail.chindris@analog.com)
+********************************************************************************
+ *   @copyright
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef SAMPLE_CONV_H
+#define SAMPLE_CONV_H
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct scan_type
+ * @brief Struct describing the scan type
+ *
+ * When storagebits is not a multiple of 8 the samples are packed one after
+ * the other, most significant bit first, and is_big_endian must be true.
+ */
+struct scan_type {
+	/** 's' or 'u' to specify signed or unsigned */
+	char			sign;
+	/** Number of valid bits of data */
+	uint8_t 		realbits;
+	/** Realbits + padding */
+	uint8_t			storagebits;
+	/** Shift right by this before masking out realbits. */
+	uint8_t			shift;
+	/** True if big endian, false if little endian */
+	bool			is_big_endian;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/**
+ * @brief Sign extend a value.
+ * @param val - Value to be extended.
+ * @param bits - Number of valid bits of val.
+ * @return The value sign extended to 32 bits.
+ */
+static inline int32_t sample_conv_sign_extend(uint32_t val, uint8_t bits)
+{
+	uint32_t sign = 1u << (bits - 1);
+
+	val &= (sign << 1) - 1;
+
+	return (int32_t)(val ^ sign) - (int32_t)sign;
+}
+
+/* Number of bytes used by nb_samples samples */
+uint32_t sample_conv_bytes(const struct scan_type *type, uint32_t nb_samples);
+/* Unpack samples to 32 bits integers */
+int32_t sample_conv_unpack(const struct scan_type *type, const void *src,
+			   int32_t *dst, uint32_t nb_samples);
+/* Unpack samples of up to 16 valid bits to 16 bits integers */
+int32_t sample_conv_unpack16(const struct scan_type *type, const void *src,
+			     int16_t *dst, uint32_t nb_samples);
+/* Unpack samples and multiply them by scale */
+int32_t sample_conv_to_float(const struct scan_type *type, const void *src,
+			     float *dst, uint32_t nb_samples, float scale);
+
+#endif /* SAMPLE_CONV_H */
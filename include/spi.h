@@ -126,6 +126,27 @@ typedef struct spi_desc {
 	void		*extra;
 } spi_desc;
 
+/**
+ * @struct spi_msg
+ * @brief Segment of an SPI message. A message is an array of segments that is
+ * transferred as a whole, with the chip select kept asserted between segments
+ * unless cs_change is set.
+ */
+struct spi_msg {
+	/** Buffer with the data to be transmitted. If NULL, zeros are sent */
+	const uint8_t	*tx_buff;
+	/** Buffer where the received data is stored. If NULL, it is dropped */
+	uint8_t		*rx_buff;
+	/** Number of bytes to write/read */
+	uint32_t	bytes_number;
+	/** Deassert the chip select after this segment. On the last segment of
+	 * a message, keep the chip select asserted instead */
+	uint8_t		cs_change;
+	/** Delay in microseconds after this segment, before the chip select
+	 * changes */
+	uint32_t	delay_us;
+};
+
 /**
  * @struct spi_platform_ops
  * @brief Structure holding SPI function pointers that point to the platform
@@ -136,6 +157,10 @@ struct spi_platform_ops {
 	int32_t (*spi_ops_init)(struct spi_desc **, const struct spi_init_param *);
 	/** SPI write/read function pointer */
 	int32_t (*spi_ops_write_and_read)(struct spi_desc *, uint8_t *, uint16_t);
+	/** SPI message transfer function pointer. Optional, if NULL the message
+	 * is split into spi_ops_write_and_read() calls */
+	int32_t (*spi_ops_transfer)(struct spi_desc *, struct spi_msg *,
+				    uint32_t);
 	/** SPI remove function pointer */
 	int32_t (*spi_ops_remove)(struct spi_desc *);
 };
@@ -156,4 +181,9 @@ int32_t spi_write_and_read(struct spi_desc *desc,
 			   uint8_t *data,
 			   uint16_t bytes_number);
 
+/* Transfer a message made of multiple segments. */
+int32_t spi_transfer(struct spi_desc *desc,
+		     struct spi_msg *msgs,
+		     uint32_t len);
+
 #endif // SPI_H_
@@ -49,7 +49,6 @@
 #include "ctype.h"
 #include "tinyiiod.h"
 #include "util.h"
-#include "list.h"
 #include "error.h"
 #include "uart.h"
 #include <inttypes.h>
@@ -57,7 +56,6 @@
 #ifdef ENABLE_IIO_NETWORK
 #include "delay.h"
 #include "tcp_socket.h"
-#include "circular_buffer.h"
 #endif
 
 /******************************************************************************/
@@ -65,8 +63,13 @@
 /******************************************************************************/
 
 #define IIOD_PORT		30431
-#define MAX_SOCKET_TO_HANDLE	4
+#define SOCKETS_INIT_SIZE	4
 #define REG_ACCESS_ATTRIBUTE	"direct_reg_access"
+#define BULK_ACCESS_ATTRIBUTE	"bulk_attr_access"
+#define CH_ID_MAX_LEN		50
+#define DEV_ID_PREFIX		"device"
+/* Initial buffer size used when rendering the xml of a device */
+#define DEV_XML_SIZE_HINT	1024
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -109,6 +112,66 @@ struct attr_fun_params {
 	struct iio_ch_info	*ch_info;
 };
 
+/**
+ * @struct iio_attr_entry
+ * @brief Entry of an attribute lookup table.
+ */
+struct iio_attr_entry {
+	/** Attribute name */
+	const char		*name;
+	/** Attribute the name refers to */
+	struct iio_attribute	*attr;
+};
+
+/**
+ * @struct iio_attr_table
+ * @brief Attributes of an array sorted by name, used for binary search.
+ */
+struct iio_attr_table {
+	/** Number of entries */
+	uint32_t		count;
+	/** Entries sorted by name */
+	struct iio_attr_entry	*entries;
+};
+
+/**
+ * @struct iio_ch_entry
+ * @brief Entry of a channel lookup table.
+ */
+struct iio_ch_entry {
+	/** Channel id as it is sent by the client. Ex: voltage0 */
+	char			id[CH_ID_MAX_LEN];
+	/** Channel the id refers to */
+	struct iio_channel	*ch;
+	/** Channel attributes */
+	struct iio_attr_table	attrs;
+};
+
+/* Key used to search a channel in the channel lookup table */
+struct iio_ch_key {
+	const char	*id;
+	bool		ch_out;
+};
+
+/**
+ * @struct iio_lookup_index
+ * @brief Immutable index built at register time. Maps channel and attribute
+ * names to their descriptors without formatting or walking the arrays of the
+ * device descriptor on each request.
+ */
+struct iio_lookup_index {
+	/** Device attributes */
+	struct iio_attr_table	attrs;
+	/** Debug attributes */
+	struct iio_attr_table	debug_attrs;
+	/** Buffer attributes */
+	struct iio_attr_table	buffer_attrs;
+	/** Number of channels */
+	uint32_t		nb_ch;
+	/** Channels sorted by direction and id */
+	struct iio_ch_entry	*ch;
+};
+
 /**
  * @struct iio_interface
  * @brief Links a physical device instance "void *dev_instance"
@@ -129,6 +192,61 @@ struct iio_interface {
 	struct iio_device	*dev_descriptor;
 	struct iio_data_buffer	*write_buffer;
 	struct iio_data_buffer	*read_buffer;
+	/** Channel and attribute lookup index */
+	struct iio_lookup_index	index;
+	/** Pre-rendered xml describing the device */
+	char			*xml;
+	/** Length of xml, without the null terminator */
+	uint32_t		xml_len;
+};
+
+/**
+ * @struct iio_zero_copy_chunk
+ * @brief Chunk of device data to be sent without copying it to the buffer
+ * of libtinyiiod. libtinyiiod sends each chunk of a buffer right after
+ * read_data, so when it writes "scratch" the bytes from "data" are sent
+ * instead.
+ */
+struct iio_zero_copy_chunk {
+	/** Buffer of libtinyiiod passed to read_data */
+	const char	*scratch;
+	/** Device data to be sent */
+	const void	*data;
+	/** Size of the chunk */
+	size_t		len;
+};
+
+/**
+ * @struct iio_bulk_entry
+ * @brief Attribute access of a bulk request. The strings point inside the
+ * request buffer.
+ */
+struct iio_bulk_entry {
+	/** 'r' read, 'R' read raw integer or 'w' write */
+	char		op;
+	/** Device id */
+	const char	*device;
+	/** "device", "debug", "buffer", "in:<channel>" or "out:<channel>" */
+	const char	*target;
+	/** Attribute name */
+	const char	*attr;
+	/** Value to be written */
+	char		*value;
+};
+
+/**
+ * @struct iio_bulk_target
+ * @brief Attribute resolved from a bulk request entry.
+ */
+struct iio_bulk_target {
+	/** Interface of the device */
+	struct iio_interface	*dev;
+	/** Attribute to be accessed */
+	struct iio_attribute	*attr;
+	/** Channel info of channel attributes */
+	struct iio_ch_info	ch_info;
+	/** &ch_info for channel attributes, NULL otherwise */
+	struct iio_ch_info	*ch;
 };
 
 struct iio_desc {
@@ -136,15 +254,35 @@ struct iio_desc {
 	struct tinyiiod_ops	*iiod_ops;
 	enum pysical_link_type	phy_type;
 	void			*phy_desc;
-	struct list_desc	*interfaces_list;
-	char			*xml_desc;
+	/* Registered interfaces indexed by the number from their dev_id */
+	struct iio_interface	**interfaces;
+	/* Interface used by the last request */
+	struct iio_interface	*last_interface;
+	/* Size of the context xml, spliced from the device fragments */
 	uint32_t		xml_size;
-	uint32_t		xml_size_to_last_dev;
 	uint32_t		dev_count;
 	struct uart_desc	*uart_desc;
+	/* Pending chunk of the zero-copy read path */
+	struct iio_zero_copy_chunk	zc_chunk;
+	/* Last bulk request, executed when BULK_ACCESS_ATTRIBUTE is read */
+	char			*bulk_req;
+	/* Entries parsed from bulk_req */
+	struct iio_bulk_entry	*bulk_entries;
+	/* Number of elements in bulk_entries */
+	uint32_t		nb_bulk_entries;
 #ifdef ENABLE_IIO_NETWORK
-	/* FIFO for socket descriptors */
-	struct circular_buffer	*sockets;
+	/* Server socket followed by the connected clients */
+	struct tcp_socket_desc	**socks;
+	/* Events of socks, filled by socket_poll */
+	struct socket_poll_entry	*poll_entries;
+	/* Number of elements in socks, the server included */
+	uint32_t		nb_socks;
+	/* Number of elements allocated in socks and poll_entries */
+	uint32_t		socks_size;
+	/* Client checked first when looking for a request, for fairness */
+	uint32_t		next_client;
+	/* Set if the network interface can't wait for socket events */
+	bool			no_poll;
 	/* Client socket active during an iio_step */
 	struct tcp_socket_desc	*current_sock;
 	/* Instance of server socket */
@@ -160,70 +298,130 @@ static struct iio_desc			*g_desc;
 
 #ifdef ENABLE_IIO_NETWORK
 
-static inline int32_t _pop_sock(struct iio_desc *desc,
-				struct tcp_socket_desc **sock)
+/* Add a connected client to the watched sockets */
+static int32_t _add_sock(struct iio_desc *desc, struct tcp_socket_desc *sock)
 {
-	return cb_read(desc->sockets, sock, sizeof(*sock));
-}
+	struct tcp_socket_desc		**socks;
+	struct socket_poll_entry	*entries;
+	uint32_t			size;
+
+	if (desc->nb_socks == desc->socks_size) {
+		size = desc->socks_size * 2;
+		socks = realloc(desc->socks, size * sizeof(*socks));
+		if (!socks)
+			return -ENOMEM;
+		desc->socks = socks;
+		entries = realloc(desc->poll_entries, size * sizeof(*entries));
+		if (!entries)
+			return -ENOMEM;
+		desc->poll_entries = entries;
+		desc->socks_size = size;
+	}
 
-static inline int32_t _push_sock(struct iio_desc *desc,
-				 struct tcp_socket_desc *sock)
-{
-	return cb_write(desc->sockets, &sock, sizeof(sock));
+	desc->socks[desc->nb_socks++] = sock;
+
+	return SUCCESS;
 }
 
-static inline int32_t _nb_active_sockets(struct iio_desc *desc)
+/* Release a disconnected client. The order of the others is kept */
+static void _remove_sock(struct iio_desc *desc, struct tcp_socket_desc *sock)
 {
-	uint32_t size;
+	uint32_t i;
+
+	for (i = 1; i < desc->nb_socks; i++)
+		if (desc->socks[i] == sock)
+			break;
+	if (i == desc->nb_socks)
+		return;
 
-	cb_size(desc->sockets, &size);
+	memmove(&desc->socks[i], &desc->socks[i + 1],
+		(desc->nb_socks - i - 1) * sizeof(*desc->socks));
+	desc->nb_socks--;
+	/* Client i - 1 is gone, the next one took its place */
+	if (desc->next_client >= i)
+		desc->next_client--;
 
-	return size / sizeof(struct tcp_socket_desc *);
+	socket_remove(sock);
 }
 
-/* Blocking until new socket available.
- * Will iterate through a list of sockets */
-static int32_t _get_next_socket(struct iio_desc *desc)
+/* Accept all the waiting connections */
+static int32_t _accept_socks(struct iio_desc *desc)
 {
 	struct tcp_socket_desc	*sock;
 	int32_t			ret;
-	uint32_t		nb_active_sockets;
 
-	/* Get all new waiting sockets.
-	 * If none is available, wait until first connection */
-	do {
+	while (true) {
 		ret = socket_accept(desc->server, &sock);
-		if (ret == -EAGAIN) {
-			nb_active_sockets = _nb_active_sockets(desc);
-			if (nb_active_sockets == 0) {
+		if (ret == -EAGAIN)
+			return SUCCESS;
+		if (IS_ERR_VALUE(ret))
+			return ret;
+
+		ret = _add_sock(desc, sock);
+		if (IS_ERR_VALUE(ret)) {
+			socket_remove(sock);
+			return ret;
+		}
+	}
+}
+
+/* Blocking until a client sends a request.
+ * Clients are served in a round robin order. If the network interface can
+ * wait for socket events, only the clients with data are selected, otherwise
+ * every client gets its turn. */
+static int32_t _get_next_socket(struct iio_desc *desc)
+{
+	uint32_t	nb_clients;
+	uint32_t	client;
+	uint32_t	i;
+	int32_t		ret;
+
+	while (true) {
+		ret = _accept_socks(desc);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+
+		nb_clients = desc->nb_socks - 1;
+		if (desc->no_poll) {
+			if (nb_clients == 0) {
 				/* Wait until a connection exists */
 				mdelay(1);
 				continue;
-			} else {
-				break;
 			}
-		} else if (IS_ERR_VALUE(ret)) {
-			return ret;
+			client = desc->next_client % nb_clients;
+			desc->next_client = client + 1;
+			desc->current_sock = desc->socks[client + 1];
+
+			return SUCCESS;
+		}
+
+		/* Wait for a request or a new connection */
+		ret = socket_poll(desc->socks, desc->nb_socks,
+				  desc->poll_entries, -1);
+		if (ret == -ENOSYS) {
+			desc->no_poll = true;
+			continue;
 		}
-		/* Add socket to queue */
-		ret = _push_sock(desc, sock);
 		if (IS_ERR_VALUE(ret))
 			return ret;
-	} while (true);
 
-	ret = _pop_sock(desc, &desc->current_sock);
-	if (IS_ERR_VALUE(ret)) {
-		desc->current_sock = NULL;
-		return ret;
-	}
+		for (i = 0; i < nb_clients; i++) {
+			client = (desc->next_client + i) % nb_clients;
+			if (desc->poll_entries[client + 1].revents) {
+				desc->next_client = client + 1;
+				desc->current_sock = desc->socks[client + 1];
 
-	return SUCCESS;
+				return SUCCESS;
+			}
+		}
+	}
 }
 
 static int32_t network_read(const void *data, uint32_t len)
 {
-	uint32_t	i;
-	int32_t		ret;
+	struct socket_poll_entry	entry;
+	uint32_t			i;
+	int32_t				ret;
 
 	if ((int32_t)g_desc->current_sock == -1)
 		return -1;
@@ -238,6 +436,12 @@ static int32_t network_read(const void *data, uint32_t len)
 	do {
 		ret = socket_recv(g_desc->current_sock,
 				  (void *)((uint8_t *)data + i), len - i);
+		if (ret == -EAGAIN && !g_desc->no_poll) {
+			/* Wait for the rest of the request */
+			ret = socket_poll(&g_desc->current_sock, 1, &entry, -1);
+			if (!IS_ERR_VALUE(ret))
+				continue;
+		}
 		if (IS_ERR_VALUE(ret)) {
 			*(int8_t *)data = '*';
 			break;
@@ -248,8 +452,8 @@ static int32_t network_read(const void *data, uint32_t len)
 
 	if (ret == -ENOTCONN) {
 		/* A socket connection is disconnected, so we release
-		 * the resources and don't add it again in the list */
-		socket_remove(g_desc->current_sock);
+		 * the resources and remove it from the list */
+		_remove_sock(g_desc, g_desc->current_sock);
 		g_desc->current_sock = (void *)-1;
 	}
 
@@ -271,7 +475,7 @@ static ssize_t iio_phy_read(char *buf, size_t len)
 }
 
 /** Write to a peripheral device (UART, USB, NETWORK) */
-static ssize_t iio_phy_write(const char *buf, size_t len)
+static ssize_t iio_phy_send(const char *buf, size_t len)
 {
 	if (g_desc->phy_type == USE_UART)
 		return (ssize_t)uart_write(g_desc->uart_desc,
@@ -284,6 +488,57 @@ static ssize_t iio_phy_write(const char *buf, size_t len)
 	return -EINVAL;
 }
 
+/**
+ * @brief Send the context xml, one device fragment at a time.
+ * @return Sum of the values returned by the physical layer or negative value
+ * in case of error.
+ */
+static ssize_t iio_phy_write_xml(void)
+{
+	ssize_t		ret;
+	ssize_t		sent;
+	uint32_t	i;
+
+	sent = iio_phy_send(header, sizeof(header) - 1);
+	if (IS_ERR_VALUE(sent))
+		return sent;
+
+	for (i = 0; i < g_desc->dev_count; i++) {
+		if (!g_desc->interfaces[i])
+			continue;
+		ret = iio_phy_send(g_desc->interfaces[i]->xml,
+				   g_desc->interfaces[i]->xml_len);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		sent += ret;
+	}
+
+	/* The null terminator is part of the context xml */
+	ret = iio_phy_send(header_end, sizeof(header_end));
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	return sent + ret;
+}
+
+/** Write data coming from libtinyiiod, expanding the zero-copy chunk and the
+ * context xml */
+static ssize_t iio_phy_write(const char *buf, size_t len)
+{
+	struct iio_zero_copy_chunk *chunk = &g_desc->zc_chunk;
+
+	if (chunk->scratch && buf == chunk->scratch && len == chunk->len) {
+		buf = chunk->data;
+		chunk->scratch = NULL;
+	}
+
+	/* iio_get_xml() hands out the header, the fragments follow it */
+	if (buf == header && len == g_desc->xml_size)
+		return iio_phy_write_xml();
+
+	return iio_phy_send(buf, len);
+}
+
 /* Get string for channel id from channel type */
 static char *get_channel_id(enum iio_chan_type type)
 {
@@ -298,6 +553,8 @@ static char *get_channel_id(enum iio_chan_type type)
 		return "anglvel";
 	case IIO_TEMP:
 		return "temp";
+	case IIO_ACCEL:
+		return "accel";
 	default:
 		return "";
 	}
@@ -325,83 +582,314 @@ static inline void _print_ch_id(char *buff, struct iio_channel *ch)
 	}
 }
 
+static int iio_cmp_attr_entry(const void *a, const void *b)
+{
+	const struct iio_attr_entry *ea = a;
+	const struct iio_attr_entry *eb = b;
+
+	return strcmp(ea->name, eb->name);
+}
+
+static int iio_cmp_attr_key(const void *key, const void *entry)
+{
+	return strcmp((const char *)key,
+		      ((const struct iio_attr_entry *)entry)->name);
+}
+
+static int iio_cmp_ch_entry(const void *a, const void *b)
+{
+	const struct iio_ch_entry *ea = a;
+	const struct iio_ch_entry *eb = b;
+
+	if (ea->ch->ch_out != eb->ch->ch_out)
+		return (int)ea->ch->ch_out - (int)eb->ch->ch_out;
+
+	return strcmp(ea->id, eb->id);
+}
+
+static int iio_cmp_ch_key(const void *key, const void *entry)
+{
+	const struct iio_ch_key		*k = key;
+	const struct iio_ch_entry	*e = entry;
+
+	if (k->ch_out != e->ch->ch_out)
+		return (int)k->ch_out - (int)e->ch->ch_out;
+
+	return strcmp(k->id, e->id);
+}
+
+/**
+ * @brief Build a sorted lookup table from an array of attributes.
+ * @param table - Table to be filled.
+ * @param attributes - Array of attributes terminated by a NULL name.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_attr_table_init(struct iio_attr_table *table,
+				   struct iio_attribute *attributes)
+{
+	uint32_t i;
+
+	table->count = 0;
+	table->entries = NULL;
+	if (!attributes)
+		return SUCCESS;
+
+	while (attributes[table->count].name)
+		table->count++;
+	if (!table->count)
+		return SUCCESS;
+
+	table->entries = (struct iio_attr_entry *)calloc(table->count,
+			 sizeof(*table->entries));
+	if (!table->entries)
+		return -ENOMEM;
+
+	for (i = 0; i < table->count; i++) {
+		table->entries[i].name = attributes[i].name;
+		table->entries[i].attr = &attributes[i];
+	}
+	qsort(table->entries, table->count, sizeof(*table->entries),
+	      iio_cmp_attr_entry);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Find an attribute in a lookup table.
+ * @param table - Lookup table.
+ * @param name - Attribute name.
+ * @return Attribute pointer if found, NULL otherwise.
+ */
+static inline struct iio_attribute *iio_attr_table_find(
+	struct iio_attr_table *table, const char *name)
+{
+	struct iio_attr_entry *entry;
+
+	if (!table->count)
+		return NULL;
+
+	entry = bsearch(name, table->entries, table->count,
+			sizeof(*table->entries),
+			iio_cmp_attr_key);
+
+	return entry ? entry->attr : NULL;
+}
+
+/**
+ * @brief Free the resources allocated by "iio_lookup_index_init()".
+ * @param index - Lookup index.
+ */
+static void iio_lookup_index_remove(struct iio_lookup_index *index)
+{
+	uint32_t i;
+
+	free(index->attrs.entries);
+	free(index->debug_attrs.entries);
+	free(index->buffer_attrs.entries);
+	if (index->ch) {
+		for (i = 0; i < index->nb_ch; i++)
+			free(index->ch[i].attrs.entries);
+		free(index->ch);
+	}
+	memset(index, 0, sizeof(*index));
+}
+
+/**
+ * @brief Build the channel and attribute lookup index of a device.
+ * Channel ids are formatted once here and the tables are sorted so requests
+ * can be resolved with a binary search.
+ * @param index - Lookup index to be filled.
+ * @param dev - Device descriptor.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_lookup_index_init(struct iio_lookup_index *index,
+				     struct iio_device *dev)
+{
+	uint32_t	i;
+	int32_t		ret;
+
+	memset(index, 0, sizeof(*index));
+
+	ret = iio_attr_table_init(&index->attrs, dev->attributes);
+	if (IS_ERR_VALUE(ret))
+		goto error;
+	ret = iio_attr_table_init(&index->debug_attrs, dev->debug_attributes);
+	if (IS_ERR_VALUE(ret))
+		goto error;
+	ret = iio_attr_table_init(&index->buffer_attrs,
+				  dev->buffer_attributes);
+	if (IS_ERR_VALUE(ret))
+		goto error;
+
+	if (!dev->channels || !dev->num_ch)
+		return SUCCESS;
+
+	index->ch = (struct iio_ch_entry *)calloc(dev->num_ch,
+			sizeof(*index->ch));
+	if (!index->ch) {
+		ret = -ENOMEM;
+		goto error;
+	}
+	index->nb_ch = dev->num_ch;
+
+	for (i = 0; i < index->nb_ch; i++) {
+		index->ch[i].ch = &dev->channels[i];
+		_print_ch_id(index->ch[i].id, &dev->channels[i]);
+		ret = iio_attr_table_init(&index->ch[i].attrs,
+					  dev->channels[i].attributes);
+		if (IS_ERR_VALUE(ret))
+			goto error;
+	}
+	qsort(index->ch, index->nb_ch, sizeof(*index->ch),
+	      iio_cmp_ch_entry);
+
+	return SUCCESS;
+error:
+	iio_lookup_index_remove(index);
+
+	return ret;
+}
+
 /**
- * @brief Get channel ID from a list of channels.
+ * @brief Get channel entry from the lookup index of a device.
  * @param channel - Channel name.
- * @param desc - Device descriptor
+ * @param index - Lookup index of the device.
  * @param ch_out - If "true" is output channel, if "false" is input channel.
- * @return Channel ID, or negative value if attribute is not found.
+ * @return Channel entry, or NULL if channel is not found.
  */
-static inline struct iio_channel *iio_get_channel(const char *channel,
-		struct iio_device *desc, bool ch_out)
+static inline struct iio_ch_entry *iio_get_channel(const char *channel,
+		struct iio_lookup_index *index, bool ch_out)
 {
-	int16_t i = 0;
-	char	ch_id[20];
+	struct iio_ch_key key;
 
-	while (i < desc->num_ch) {
-		_print_ch_id(ch_id, &desc->channels[i]);
-		if (!strcmp(channel, ch_id) &&
-		    (desc->channels[i].ch_out == ch_out))
-			return &desc->channels[i];
-		i++;
-	}
+	if (!index->nb_ch)
+		return NULL;
+
+	key.id = channel;
+	key.ch_out = ch_out;
 
-	return NULL;
+	return bsearch(&key, index->ch, index->nb_ch, sizeof(*index->ch),
+		       iio_cmp_ch_key);
 }
 
 /**
  * @brief Find interface with "device_name".
+ * The interface used by the previous request is checked first, since
+ * libtinyiiod addresses the same device for every chunk of a buffer.
+ * Otherwise the number from "deviceN" is used as index in the interfaces table.
  * @param device_name - Device name.
- * @param iio_interfaces - List of interfaces.
  * @return Interface pointer if interface is found, NULL otherwise.
  */
 static struct iio_interface *iio_get_interface(const char *device_name)
 {
 	struct iio_interface	*interface;
-	struct iio_interface	cmp_val;
-	int32_t					ret;
+	const char		*p;
+	uint32_t		id;
 
-	strcpy(cmp_val.dev_id, device_name);
+	interface = g_desc->last_interface;
+	if (interface && !strcmp(interface->dev_id, device_name))
+		return interface;
 
-	ret = list_read_find(g_desc->interfaces_list,
-			     (void **)&interface, &cmp_val);
-	if (IS_ERR_VALUE(ret))
+	if (strncmp(device_name, DEV_ID_PREFIX, sizeof(DEV_ID_PREFIX) - 1))
+		return NULL;
+
+	p = device_name + sizeof(DEV_ID_PREFIX) - 1;
+	if (!isdigit((unsigned char)*p))
 		return NULL;
 
+	id = 0;
+	while (isdigit((unsigned char)*p)) {
+		id = id * 10 + (*p - '0');
+		if (id >= g_desc->dev_count)
+			return NULL;
+		p++;
+	}
+	if (*p != '\0')
+		return NULL;
+
+	interface = g_desc->interfaces[id];
+	if (interface)
+		g_desc->last_interface = interface;
+
 	return interface;
 }
 
+/* Store a value in the big endian format used by the iio protocol */
+static inline void iio_put_be32(char *buf, uint32_t val)
+{
+	buf[0] = val >> 24;
+	buf[1] = val >> 16;
+	buf[2] = val >> 8;
+	buf[3] = val;
+}
+
+/* Load a value in the big endian format used by the iio protocol */
+static inline uint32_t iio_get_be32(const char *buf)
+{
+	return ((uint32_t)(uint8_t)buf[0] << 24) |
+	       ((uint32_t)(uint8_t)buf[1] << 16) |
+	       ((uint32_t)(uint8_t)buf[2] << 8) |
+	       (uint32_t)(uint8_t)buf[3];
+}
+
+/**
+ * @brief Add one value to a response made of length prefixed values.
+ *
+ * The value is already in place, after the 4 bytes of its length. The length
+ * is written and the value is padded with zeros to a multiple of 4.
+ * @param buf - Response buffer.
+ * @param len - Size of the response buffer.
+ * @param offset - Offset of the length of the value in buf.
+ * @param value_len - Length of the value or negative error code.
+ * @return Offset of the next value or negative value in case of error.
+ */
+static ssize_t iio_put_value(char *buf, size_t len, size_t offset,
+			     ssize_t value_len)
+{
+	size_t padded;
+
+	iio_put_be32(buf + offset, value_len);
+	offset += 4;
+	if (value_len <= 0)
+		return offset;
+
+	padded = (value_len + 3) & ~3;
+	if (padded > len - offset)
+		return -ENOMEM;
+	memset(buf + offset + value_len, 0, padded - value_len);
+
+	return offset + padded;
+}
+
 /**
  * @brief Read all attributes from an attribute list.
- * @param device - Physical instance of a device.
- * @param buf - Buffer where values are read.
- * @param len - Maximum length of value to be stored in buf.
- * @param channel - Channel properties.
+ *
+ * Each value is generated straight into the response, after its length.
+ * @param params - Structure describing parameters for show functions.
  * @param attributes - List of attributes to be read.
  * @return Number of bytes read or negative value in case of error.
  */
 static ssize_t iio_read_all_attr(struct attr_fun_params *params,
 				 struct iio_attribute *attributes)
 {
-	int16_t i = 0, j = 0;
-	char local_buf[256];
 	ssize_t attr_length;
-	uint32_t *pattr_length;
+	ssize_t j = 0;
+	int16_t i = 0;
 
 	while (attributes[i].name) {
+		if (params->len - j < 4)
+			return -ENOMEM;
 		attr_length = attributes[i].show(params->dev_instance,
-						 local_buf, params->len,
+						 params->buf + j + 4,
+						 params->len - j - 4,
 						 params->ch_info,
 						 attributes[i].priv);
-		pattr_length = (uint32_t *)(params->buf + j);
-		*pattr_length = bswap_constant_32(attr_length);
-		j += 4;
-		if (attr_length >= 0) {
-			sprintf(params->buf + j, "%s", local_buf);
-			if (attr_length & 0x3) /* multiple of 4 */
-				attr_length = ((attr_length >> 2) + 1) << 2;
-			j += attr_length;
-		}
+		/* snprintf returns the length it would have needed */
+		if (attr_length >= (ssize_t)(params->len - j - 4))
+			return -ENOMEM;
+		j = iio_put_value(params->buf, params->len, j, attr_length);
+		if (IS_ERR_VALUE(j))
+			return j;
 		i++;
 	}
 
@@ -410,22 +898,24 @@ static ssize_t iio_read_all_attr(struct attr_fun_params *params,
 
 /**
  * @brief Write all attributes from an attribute list.
- * @param device - Physical instance of a device.
- * @param buf - Values to be written.
- * @param len - Length of buf.
- * @param channel - Channel properties.
+ * @param params - Structure describing parameters for store functions.
  * @param attributes - List of attributes to be written.
  * @return Number of written bytes or negative value in case of error.
  */
 static ssize_t iio_write_all_attr(struct attr_fun_params *params,
 				  struct iio_attribute *attributes)
 {
-	int16_t i = 0, j = 0;
-	int16_t attr_length;
+	size_t attr_length;
+	size_t j = 0;
+	int16_t i = 0;
 
 	while (attributes[i].name) {
-		attr_length = bswap_constant_32((uint32_t)(params->buf + j));
+		if (params->len - j < 4)
+			return -EINVAL;
+		attr_length = iio_get_be32(params->buf + j);
 		j += 4;
+		if (attr_length > params->len - j)
+			return -EINVAL;
 		attributes[i].store(params->dev_instance, (params->buf + j),
 				    attr_length, params->ch_info,
 				    attributes[i].priv);
@@ -438,45 +928,307 @@ static ssize_t iio_write_all_attr(struct attr_fun_params *params,
 	return params->len;
 }
 
+/* Split the next space separated token of a bulk request line */
+static char *iio_bulk_next_token(char **cursor)
+{
+	char *token;
+
+	while (**cursor == ' ')
+		(*cursor)++;
+	if (**cursor == '\0')
+		return NULL;
+
+	token = *cursor;
+	while (**cursor != ' ' && **cursor != '\0')
+		(*cursor)++;
+	if (**cursor == ' ')
+		*(*cursor)++ = '\0';
+
+	return token;
+}
+
+/**
+ * @brief Parse a bulk request.
+ *
+ * The request has one attribute access per line:
+ *	r <device> <target> <attr>
+ *	R <device> <target> <attr>
+ *	w <device> <target> <attr> <value>
+ * where target is "device", "debug", "buffer", "in:<channel>" or
+ * "out:<channel>".
+ * @param desc - iio descriptor.
+ * @param buf - Request.
+ * @param len - Length of the request.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_bulk_parse(struct iio_desc *desc, const char *buf,
+			      size_t len)
+{
+	struct iio_bulk_entry	*entry;
+	uint32_t		nb_lines;
+	char			*op;
+	char			*line;
+	char			*next;
+	size_t			i;
+
+	free(desc->bulk_req);
+	free(desc->bulk_entries);
+	desc->bulk_entries = NULL;
+	desc->nb_bulk_entries = 0;
+
+	desc->bulk_req = malloc(len + 1);
+	if (!desc->bulk_req)
+		return -ENOMEM;
+	memcpy(desc->bulk_req, buf, len);
+	desc->bulk_req[len] = '\0';
+
+	for (i = 0, nb_lines = 1; i < len; i++)
+		if (buf[i] == '\n')
+			nb_lines++;
+
+	desc->bulk_entries = calloc(nb_lines, sizeof(*desc->bulk_entries));
+	if (!desc->bulk_entries)
+		return -ENOMEM;
+
+	for (line = desc->bulk_req; line; line = next) {
+		next = strchr(line, '\n');
+		if (next)
+			*next++ = '\0';
+
+		entry = &desc->bulk_entries[desc->nb_bulk_entries];
+		op = iio_bulk_next_token(&line);
+		if (!op)
+			continue;
+		if (op[1] != '\0')
+			return -EINVAL;
+		entry->op = op[0];
+		entry->device = iio_bulk_next_token(&line);
+		entry->target = iio_bulk_next_token(&line);
+		entry->attr = iio_bulk_next_token(&line);
+		if (!entry->attr)
+			return -EINVAL;
+
+		if (entry->op == 'w') {
+			while (*line == ' ')
+				line++;
+			entry->value = line;
+		} else if (entry->op != 'r' && entry->op != 'R') {
+			return -EINVAL;
+		}
+		desc->nb_bulk_entries++;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Find the attribute of a bulk request entry.
+ * @param entry - Bulk request entry.
+ * @param target - Where the attribute is stored.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_bulk_resolve(struct iio_bulk_entry *entry,
+				struct iio_bulk_target *target)
+{
+	struct iio_attr_table	*table;
+	struct iio_ch_entry	*ch;
+	bool			ch_out;
+
+	target->dev = iio_get_interface(entry->device);
+	if (!target->dev)
+		return -ENODEV;
+
+	target->ch = NULL;
+	if (!strcmp(entry->target, "device")) {
+		table = &target->dev->index.attrs;
+	} else if (!strcmp(entry->target, "debug")) {
+		table = &target->dev->index.debug_attrs;
+	} else if (!strcmp(entry->target, "buffer")) {
+		table = &target->dev->index.buffer_attrs;
+	} else {
+		if (!strncmp(entry->target, "in:", 3))
+			ch_out = false;
+		else if (!strncmp(entry->target, "out:", 4))
+			ch_out = true;
+		else
+			return -EINVAL;
+
+		ch = iio_get_channel(strchr(entry->target, ':') + 1,
+				     &target->dev->index, ch_out);
+		if (!ch)
+			return -ENOENT;
+		target->ch_info.ch_out = ch_out;
+		target->ch_info.ch_num = ch->ch->channel;
+		target->ch = &target->ch_info;
+		table = &ch->attrs;
+	}
+
+	target->attr = iio_attr_table_find(table, entry->attr);
+	if (!target->attr)
+		return -ENOENT;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Execute one entry of a bulk request.
+ * @param entry - Bulk request entry.
+ * @param buf - Where the read value is stored.
+ * @param len - Size of buf.
+ * @return Length of the read value, result of the store function or negative
+ * value in case of error.
+ */
+static ssize_t iio_bulk_exec_entry(struct iio_bulk_entry *entry, char *buf,
+				   size_t len)
+{
+	struct iio_bulk_target	target;
+	int64_t			raw;
+	ssize_t			ret;
+
+	ret = iio_bulk_resolve(entry, &target);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	switch (entry->op) {
+	case 'r':
+		if (!target.attr->show)
+			return -ENOENT;
+		ret = target.attr->show(target.dev->dev_instance, buf, len,
+					target.ch, target.attr->priv);
+		if (ret >= (ssize_t)len)
+			return -ENOMEM;
+
+		return ret;
+	case 'R':
+		if (!target.attr->show_raw)
+			return -EOPNOTSUPP;
+		if (len < 8)
+			return -ENOMEM;
+		ret = target.attr->show_raw(target.dev->dev_instance, &raw,
+					    target.ch, target.attr->priv);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		iio_put_be32(buf, (uint64_t)raw >> 32);
+		iio_put_be32(buf + 4, raw);
+
+		return 8;
+	default:
+		if (!target.attr->store)
+			return -ENOENT;
+
+		return target.attr->store(target.dev->dev_instance,
+					  entry->value, strlen(entry->value),
+					  target.ch, target.attr->priv);
+	}
+}
+
+/**
+ * @brief Read BULK_ACCESS_ATTRIBUTE: execute the last bulk request.
+ *
+ * The response holds, for each entry, a big endian 32 bits length or
+ * negative error code, followed for reads by the value padded to a multiple
+ * of 4 bytes. Raw reads return a big endian 64 bits integer. For writes the
+ * length holds the result of the store function and no value follows.
+ * @param desc - iio descriptor.
+ * @param buf - Response buffer.
+ * @param len - Size of the response buffer.
+ * @return Length of the response or negative value in case of error.
+ */
+static ssize_t iio_bulk_read(struct iio_desc *desc, char *buf, size_t len)
+{
+	struct iio_bulk_entry	*entry;
+	ssize_t			ret;
+	ssize_t			j = 0;
+	uint32_t		i;
+
+	for (i = 0; i < desc->nb_bulk_entries; i++) {
+		entry = &desc->bulk_entries[i];
+		if (len - j < 4)
+			return -ENOMEM;
+
+		ret = iio_bulk_exec_entry(entry, buf + j + 4, len - j - 4);
+		if (entry->op == 'w') {
+			iio_put_be32(buf + j, ret);
+			j += 4;
+			continue;
+		}
+
+		j = iio_put_value(buf, len, j, ret);
+		if (IS_ERR_VALUE(j))
+			return j;
+	}
+
+	return j;
+}
+
+/**
+ * @brief Write BULK_ACCESS_ATTRIBUTE: store a bulk request.
+ *
+ * A request made only of writes is executed right away, otherwise it is
+ * executed when BULK_ACCESS_ATTRIBUTE is read.
+ * @param desc - iio descriptor.
+ * @param buf - Request.
+ * @param len - Length of the request.
+ * @return len in case of success or negative value otherwise.
+ */
+static ssize_t iio_bulk_write(struct iio_desc *desc, const char *buf,
+			      size_t len)
+{
+	ssize_t		ret;
+	uint32_t	i;
+
+	ret = iio_bulk_parse(desc, buf, len);
+	if (IS_ERR_VALUE(ret)) {
+		desc->nb_bulk_entries = 0;
+		return ret;
+	}
+
+	for (i = 0; i < desc->nb_bulk_entries; i++)
+		if (desc->bulk_entries[i].op != 'w')
+			return len;
+
+	/* Executed once, a later read must not replay the writes */
+	for (i = 0; i < desc->nb_bulk_entries; i++) {
+		ret = iio_bulk_exec_entry(&desc->bulk_entries[i], NULL, 0);
+		if (IS_ERR_VALUE(ret))
+			break;
+	}
+	desc->nb_bulk_entries = 0;
+
+	return IS_ERR_VALUE(ret) ? ret : (ssize_t)len;
+}
+
 /**
  * @brief Read/write attribute.
  * @param params - Structure describing parameters for store and show functions
- * @param attributes - Array of attributes.
+ * @param table - Lookup table of the attributes.
  * @param attr_name - Attribute name to be modified
  * @param is_write -If it has value "1", writes attribute, otherwise reads
  * 		attribute.
  * @return Length of chars written/read or negative value in case of error.
  */
 static ssize_t iio_rd_wr_attribute(struct attr_fun_params *params,
-				   struct iio_attribute *attributes,
+				   struct iio_attr_table *table,
 				   char *attr_name,
 				   bool is_write)
 {
-	int16_t i = 0;
+	struct iio_attribute *attr;
 
-	/* Search attribute */
-	while (attributes[i].name) {
-		if (!strcmp(attr_name, attributes[i].name))
-			break;
-		i++;
-	}
-
-	if (!attributes[i].name)
+	attr = iio_attr_table_find(table, attr_name);
+	if (!attr)
 		return -ENOENT;
 
 	if (is_write) {
-		if (!attributes[i].store)
+		if (!attr->store)
 			return -ENOENT;
 
-		return attributes[i].store(params->dev_instance, params->buf,
-					   params->len, params->ch_info,
-					   attributes[i].priv);
+		return attr->store(params->dev_instance, params->buf,
+				   params->len, params->ch_info, attr->priv);
 	} else {
-		if (!attributes[i].show)
+		if (!attr->show)
 			return -ENOENT;
-		return attributes[i].show(params->dev_instance, params->buf,
-					  params->len, params->ch_info,
-					  attributes[i].priv);
+		return attr->show(params->dev_instance, params->buf,
+				  params->len, params->ch_info, attr->priv);
 	}
 }
 
@@ -552,6 +1304,7 @@ static ssize_t iio_read_attr(const char *device_id, const char *attr, char *buf,
 	struct iio_interface	*dev;
 	struct attr_fun_params	params;
 	struct iio_attribute	*attributes;
+	struct iio_attr_table	*table;
 
 	dev = iio_get_interface(device_id);
 	if (!dev)
@@ -562,6 +1315,7 @@ static ssize_t iio_read_attr(const char *device_id, const char *attr, char *buf,
 	params.dev_instance = dev->dev_instance;
 	params.ch_info = NULL;
 	attributes = NULL;
+	table = NULL;
 	switch (type) {
 	case IIO_ATTR_TYPE_DEBUG:
 		if (strcmp(attr, REG_ACCESS_ATTRIBUTE) == 0) {
@@ -570,20 +1324,25 @@ static ssize_t iio_read_attr(const char *device_id, const char *attr, char *buf,
 			else
 				return -ENOENT;
 		}
+		if (strcmp(attr, BULK_ACCESS_ATTRIBUTE) == 0)
+			return iio_bulk_read(g_desc, buf, len);
 		attributes = dev->dev_descriptor->debug_attributes;
+		table = &dev->index.debug_attrs;
 		break;
 	case IIO_ATTR_TYPE_DEVICE:
 		attributes = dev->dev_descriptor->attributes;
+		table = &dev->index.attrs;
 		break;
 	case IIO_ATTR_TYPE_BUFFER:
 		attributes = dev->dev_descriptor->buffer_attributes;
+		table = &dev->index.buffer_attrs;
 		break;
 	}
 
 	if (!strcmp(attr, ""))
 		return iio_read_all_attr(&params, attributes);
 	else
-		return iio_rd_wr_attribute(&params,attributes, (char *)attr, 0);
+		return iio_rd_wr_attribute(&params, table, (char *)attr, 0);
 }
 
 /**
@@ -602,6 +1361,7 @@ static ssize_t iio_write_attr(const char *device_id, const char *attr,
 	struct iio_interface	*dev;
 	struct attr_fun_params	params;
 	struct iio_attribute	*attributes;
+	struct iio_attr_table	*table;
 
 	dev = iio_get_interface(device_id);
 	if (!dev)
@@ -612,6 +1372,7 @@ static ssize_t iio_write_attr(const char *device_id, const char *attr,
 	params.dev_instance = dev->dev_instance;
 	params.ch_info = NULL;
 	attributes = NULL;
+	table = NULL;
 	switch (type) {
 	case IIO_ATTR_TYPE_DEBUG:
 		if (strcmp(attr, REG_ACCESS_ATTRIBUTE) == 0) {
@@ -620,20 +1381,25 @@ static ssize_t iio_write_attr(const char *device_id, const char *attr,
 			else
 				return -ENOENT;
 		}
+		if (strcmp(attr, BULK_ACCESS_ATTRIBUTE) == 0)
+			return iio_bulk_write(g_desc, buf, len);
 		attributes = dev->dev_descriptor->debug_attributes;
+		table = &dev->index.debug_attrs;
 		break;
 	case IIO_ATTR_TYPE_DEVICE:
 		attributes = dev->dev_descriptor->attributes;
+		table = &dev->index.attrs;
 		break;
 	case IIO_ATTR_TYPE_BUFFER:
 		attributes = dev->dev_descriptor->buffer_attributes;
+		table = &dev->index.buffer_attrs;
 		break;
 	}
 
 	if (!strcmp(attr, ""))
 		return iio_write_all_attr(&params, attributes);
 	else
-		return iio_rd_wr_attribute(&params, attributes, (char *)attr, 1);
+		return iio_rd_wr_attribute(&params, table, (char *)attr, 1);
 }
 
 /**
@@ -651,27 +1417,27 @@ static ssize_t iio_ch_read_attr(const char *device_id, const char *channel,
 {
 	struct iio_interface	*dev;
 	struct iio_ch_info	ch_info;
-	struct iio_channel	*ch;
+	struct iio_ch_entry	*ch;
 	struct attr_fun_params	params;
 
 	dev = iio_get_interface(device_id);
 	if (!dev)
 		return FAILURE;
 
-	ch = iio_get_channel(channel, dev->dev_descriptor, ch_out);
+	ch = iio_get_channel(channel, &dev->index, ch_out);
 	if (!ch)
 		return -ENOENT;
 
 	ch_info.ch_out = ch_out;
-	ch_info.ch_num = ch->channel;
+	ch_info.ch_num = ch->ch->channel;
 	params.buf = buf;
 	params.len = len;
 	params.dev_instance = dev->dev_instance;
 	params.ch_info = &ch_info;
 	if (!strcmp(attr, ""))
-		return iio_read_all_attr(&params, ch->attributes);
+		return iio_read_all_attr(&params, ch->ch->attributes);
 	else
-		return iio_rd_wr_attribute(&params, ch->attributes, (char *)attr, 0);
+		return iio_rd_wr_attribute(&params, &ch->attrs, (char *)attr, 0);
 }
 
 /**
@@ -689,27 +1455,27 @@ static ssize_t iio_ch_write_attr(const char *device_id, const char *channel,
 {
 	struct iio_interface	*dev;
 	struct iio_ch_info	ch_info;
-	struct iio_channel	*ch;
+	struct iio_ch_entry	*ch;
 	struct attr_fun_params	params;
 
 	dev = iio_get_interface(device_id);
 	if (!dev)
 		return -ENOENT;
 
-	ch = iio_get_channel(channel, dev->dev_descriptor, ch_out);
+	ch = iio_get_channel(channel, &dev->index, ch_out);
 	if (!ch)
 		return -ENOENT;
 
 	ch_info.ch_out = ch_out;
-	ch_info.ch_num = ch->channel;
+	ch_info.ch_num = ch->ch->channel;
 	params.buf = (char *)buf;
 	params.len = len;
 	params.dev_instance = dev->dev_instance;
 	params.ch_info = &ch_info;
 	if (!strcmp(attr, ""))
-		return iio_write_all_attr(&params, ch->attributes);
+		return iio_write_all_attr(&params, ch->ch->attributes);
 	else
-		return iio_rd_wr_attribute(&params, ch->attributes, (char *)attr, 1);
+		return iio_rd_wr_attribute(&params, &ch->attrs, (char *)attr, 1);
 }
 
 /**
@@ -858,6 +1624,10 @@ static ssize_t iio_read_dev(const char *device, char *pbuf, size_t offset,
 			    size_t bytes_count)
 {
 	struct iio_interface *iio_interface = iio_get_interface(device);
+	void	*data;
+	ssize_t	ret;
+
+	g_desc->zc_chunk.scratch = NULL;
 
 	if (iio_interface->dev_descriptor->read_data)
 		return iio_interface->dev_descriptor->read_data(
@@ -865,20 +1635,30 @@ static ssize_t iio_read_dev(const char *device, char *pbuf, size_t offset,
 			       pbuf, offset,
 			       bytes_count, iio_interface->ch_mask);
 
-	//else
-	struct iio_data_buffer *r_buff;
+	if (iio_interface->dev_descriptor->get_read_data_ptr) {
+		ret = iio_interface->dev_descriptor->get_read_data_ptr(
+			      iio_interface->dev_instance, &data, offset,
+			      bytes_count, iio_interface->ch_mask);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	} else {
+		struct iio_data_buffer *r_buff;
 
-	r_buff = iio_interface->read_buffer;
-	if (r_buff) {
+		r_buff = iio_interface->read_buffer;
+		if (!r_buff)
+			return -ENOENT;
 		if (offset + bytes_count > r_buff->size)
 			return -ENOMEM;
 
-		memcpy(pbuf, r_buff->buff + offset, bytes_count);
-
-		return bytes_count;
+		data = (char *)r_buff->buff + offset;
 	}
 
-	return -ENOENT;
+	/* The chunk is sent from "data" by iio_phy_write() */
+	g_desc->zc_chunk.scratch = pbuf;
+	g_desc->zc_chunk.data = data;
+	g_desc->zc_chunk.len = bytes_count;
+
+	return bytes_count;
 }
 
 /**
@@ -952,15 +1732,19 @@ static ssize_t iio_write_dev(const char *device, const char *buf,
 
 /**
  * @brief Get a merged xml containing all devices.
+ *
+ * The xml is never merged in memory. The returned buffer only holds the
+ * header and iio_phy_write() sends the device fragments after it, when it is
+ * asked to write the whole context.
  * @param outxml - Generated xml.
- * @return SUCCESS in case of success or negative value otherwise.
+ * @return Size of the xml in case of success or negative value otherwise.
  */
 static ssize_t iio_get_xml(char **outxml)
 {
 	if (!outxml)
 		return FAILURE;
 
-	*outxml = g_desc->xml_desc;
+	*outxml = header;
 
 	return g_desc->xml_size;
 }
@@ -972,18 +1756,11 @@ static ssize_t iio_get_xml(char **outxml)
  */
 ssize_t iio_step(struct iio_desc *desc)
 {
-#ifdef ENABLE_IIO_NETWORK
-	int32_t ret;
+	desc->zc_chunk.scratch = NULL;
 
-	if (desc->phy_type == USE_NETWORK) {
-		if (desc->current_sock != NULL &&
-		    (int32_t)desc->current_sock != -1) {
-			ret = _push_sock(desc, desc->current_sock);
-			if (IS_ERR_VALUE(ret))
-				return ret;
-		}
+#ifdef ENABLE_IIO_NETWORK
+	if (desc->phy_type == USE_NETWORK)
 		desc->current_sock = NULL;
-	}
 #endif
 	return tinyiiod_read_command(desc->iiod);
 }
@@ -999,7 +1776,7 @@ static uint32_t iio_generate_device_xml(struct iio_device *device, char *name,
 {
 	struct iio_channel	*ch;
 	struct iio_attribute	*attr;
-	char			ch_id[50];
+	char			ch_id[CH_ID_MAX_LEN];
 	int32_t			i;
 	int32_t			j;
 	int32_t			k;
@@ -1077,6 +1854,8 @@ static uint32_t iio_generate_device_xml(struct iio_device *device, char *name,
 	if (device->debug_reg_read || device->debug_reg_write)
 		i += snprintf(buff + i, max(n - i, 0),
 			      "<debug-attribute name=\""REG_ACCESS_ATTRIBUTE"\" />");
+	i += snprintf(buff + i, max(n - i, 0),
+		      "<debug-attribute name=\""BULK_ACCESS_ATTRIBUTE"\" />");
 
 	/* Write buffer attributes */
 	if (device->buffer_attributes)
@@ -1090,6 +1869,55 @@ static uint32_t iio_generate_device_xml(struct iio_device *device, char *name,
 	return i;
 }
 
+/**
+ * @brief Render the xml fragment of a device.
+ *
+ * The fragment is generated in a single pass when it fits in
+ * DEV_XML_SIZE_HINT bytes.
+ * @param intf - Interface of the device.
+ * @param id - Number of the device.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static int32_t iio_render_device_xml(struct iio_interface *intf, int32_t id)
+{
+	uint32_t	size;
+	uint32_t	n;
+	char		*buff;
+
+	size = DEV_XML_SIZE_HINT;
+	while (true) {
+		buff = realloc(intf->xml, size);
+		if (!buff)
+			return -ENOMEM;
+		intf->xml = buff;
+
+		n = iio_generate_device_xml(intf->dev_descriptor,
+					    (char *)intf->name, id, buff, size);
+		if (n < size)
+			break;
+		size = n + 1;
+	}
+
+	/* Give back the unused space */
+	buff = realloc(intf->xml, n + 1);
+	if (buff)
+		intf->xml = buff;
+	intf->xml_len = n;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources of a registered interface.
+ * @param intf - Interface to be freed.
+ */
+static void iio_interface_free(struct iio_interface *intf)
+{
+	iio_lookup_index_remove(&intf->index);
+	free(intf->xml);
+	free(intf);
+}
+
 /**
  * @brief Register interface.
  * @param desc - iio descriptor
@@ -1104,10 +1932,8 @@ ssize_t iio_register(struct iio_desc *desc, struct iio_device *dev_descriptor,
 		     struct iio_data_buffer *write_buff)
 {
 	struct iio_interface	*iio_interface;
+	struct iio_interface	**interfaces;
 	int32_t ret;
-	int32_t	n;
-	int32_t	new_size;
-	char	*aux;
 
 	iio_interface = (struct iio_interface *)calloc(1,
 			sizeof(*iio_interface));
@@ -1119,37 +1945,30 @@ ssize_t iio_register(struct iio_desc *desc, struct iio_device *dev_descriptor,
 	iio_interface->read_buffer = read_buff;
 	iio_interface->write_buffer = write_buff;
 
-	/* Get number of bytes needed for the xml of the new device */
-	n = iio_generate_device_xml(iio_interface->dev_descriptor,
-				    (char *)iio_interface->name,
-				    desc->dev_count, NULL, -1);
-
-	new_size = desc->xml_size + n;
-	aux = realloc(desc->xml_desc, new_size);
-	if (!aux) {
+	ret = iio_lookup_index_init(&iio_interface->index, dev_descriptor);
+	if (IS_ERR_VALUE(ret)) {
 		free(iio_interface);
-		return -ENOMEM;
+		return ret;
 	}
 
-	ret = desc->interfaces_list->push(desc->interfaces_list, iio_interface);
+	ret = iio_render_device_xml(iio_interface, desc->dev_count);
 	if (IS_ERR_VALUE(ret)) {
-		free(iio_interface);
-		free(aux);
+		iio_interface_free(iio_interface);
 		return ret;
 	}
 
-	desc->xml_desc = aux;
-	/* Print the new device xml at the end of the xml */
-	iio_generate_device_xml(iio_interface->dev_descriptor,
-				(char *)iio_interface->name,
-				desc->dev_count,
-				desc->xml_desc + desc->xml_size_to_last_dev,
-				new_size - desc->xml_size_to_last_dev);
-	sprintf((char *)iio_interface->dev_id, "device%d", (int)desc->dev_count);
-	desc->xml_size_to_last_dev += n;
-	desc->xml_size += n;
-	/* Copy end header at the end */
-	strcat(desc->xml_desc, header_end);
+	interfaces = realloc(desc->interfaces,
+			     (desc->dev_count + 1) * sizeof(*interfaces));
+	if (!interfaces) {
+		iio_interface_free(iio_interface);
+		return -ENOMEM;
+	}
+	desc->interfaces = interfaces;
+	desc->interfaces[desc->dev_count] = iio_interface;
+
+	sprintf((char *)iio_interface->dev_id, DEV_ID_PREFIX"%d",
+		(int)desc->dev_count);
+	desc->xml_size += iio_interface->xml_len;
 
 	desc->dev_count++;
 
@@ -1164,41 +1983,28 @@ ssize_t iio_register(struct iio_desc *desc, struct iio_device *dev_descriptor,
 ssize_t iio_unregister(struct iio_desc *desc, char *name)
 {
 	struct iio_interface	*to_remove_interface;
-	struct iio_interface	search_interface;
-	int32_t			ret;
-	int32_t			n;
-	char			*aux;
+	uint32_t		i;
 
-	/* Get if the item is found, get will remove it from the list */
-	search_interface.name = name;
-	ret = list_get_find(desc->interfaces_list,
-			    (void **)&to_remove_interface, &search_interface);
-	if (IS_ERR_VALUE(ret))
-		return ret;
-	free(to_remove_interface);
-
-	/* Get number of bytes needed for the xml of the device */
-	n = iio_generate_device_xml(to_remove_interface->dev_descriptor,
-				    (char *)to_remove_interface->name,
-				    desc->dev_count, NULL, -1);
+	for (i = 0; i < desc->dev_count; i++)
+		if (desc->interfaces[i] &&
+		    !strcmp(desc->interfaces[i]->name, name))
+			break;
+	if (i == desc->dev_count)
+		return -ENODEV;
 
-	/* Overwritte the deleted device */
-	aux = desc->xml_desc + desc->xml_size_to_last_dev - n;
-	memmove(aux, aux + n, strlen(aux + n));
+	/* The slot is kept empty so the ids of the other devices don't change */
+	to_remove_interface = desc->interfaces[i];
+	desc->interfaces[i] = NULL;
+	if (desc->last_interface == to_remove_interface)
+		desc->last_interface = NULL;
 
-	/* Decrease the xml size */
-	desc->xml_size -= n;
-	desc->xml_size_to_last_dev -= n;
+	/* Only the fragment of the device is dropped */
+	desc->xml_size -= to_remove_interface->xml_len;
+	iio_interface_free(to_remove_interface);
 
 	return SUCCESS;
 }
 
-static int32_t iio_cmp_interfaces(struct iio_interface *a,
-				  struct iio_interface *b)
-{
-	return strcmp(a->dev_id, b->dev_id);
-}
-
 /**
  * @brief Set communication ops and read/write ops that will be called
  * from "libtinyiiod".
@@ -1242,14 +2048,7 @@ ssize_t iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 	ops->read = iio_phy_read;
 	ops->write = iio_phy_write;
 
-	ldesc->xml_size = sizeof(header) + sizeof(header_end);
-	ldesc->xml_desc = (char *)malloc(ldesc->xml_size);
-	if (!ldesc->xml_desc)
-		goto free_desc;
-
-	strcpy(ldesc->xml_desc, header);
-	strcat(ldesc->xml_desc, header_end);
-	ldesc->xml_size_to_last_dev = sizeof(header) - 1;
+	ldesc->xml_size = sizeof(header) - 1 + sizeof(header_end);
 
 	ldesc->phy_type = init_param->phy_type;
 	if (init_param->phy_type == USE_UART) {
@@ -1270,10 +2069,14 @@ ssize_t iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 		ret = socket_listen(ldesc->server, 0);
 		if (IS_ERR_VALUE(ret))
 			goto free_pylink;
-		ret = cb_init(&ldesc->sockets, sizeof(struct tcp_socket_desc *)
-			      * MAX_SOCKET_TO_HANDLE);
-		if (IS_ERR_VALUE(ret))
+		ldesc->socks = calloc(SOCKETS_INIT_SIZE, sizeof(*ldesc->socks));
+		ldesc->poll_entries = calloc(SOCKETS_INIT_SIZE,
+					     sizeof(*ldesc->poll_entries));
+		if (!ldesc->socks || !ldesc->poll_entries)
 			goto free_pylink;
+		ldesc->socks_size = SOCKETS_INIT_SIZE;
+		ldesc->socks[0] = ldesc->server;
+		ldesc->nb_socks = 1;
 	}
 #endif
 	else {
@@ -1285,30 +2088,23 @@ ssize_t iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 
 	ops->get_xml = iio_get_xml;
 
-	ret = list_init(&ldesc->interfaces_list, LIST_PRIORITY_LIST,
-			(f_cmp)iio_cmp_interfaces);
-	if (IS_ERR_VALUE(ret))
-		goto free_pylink;
-
 	ldesc->iiod = tinyiiod_create(ops);
 	if (!(ldesc->iiod))
-		goto free_list;
+		goto free_pylink;
 
 	*desc = ldesc;
 	g_desc = ldesc;
 
 	return SUCCESS;
 
-free_list:
-	list_remove(ldesc->interfaces_list);
 free_pylink:
 	if (ldesc->phy_type == USE_UART)
 		uart_remove(ldesc->uart_desc);
 #ifdef ENABLE_IIO_NETWORK
 	else {
 		socket_remove(ldesc->server);
-		if (ldesc->sockets)
-			cb_remove(ldesc->sockets);
+		free(ldesc->socks);
+		free(ldesc->poll_entries);
 	}
 #endif
 free_desc:
@@ -1326,25 +2122,30 @@ free_ops:
  */
 ssize_t iio_remove(struct iio_desc *desc)
 {
-	struct iio_interface	*iio_interface;
+	uint32_t i;
 
-	while (SUCCESS == list_get_first(desc->interfaces_list,
-					 (void **)&iio_interface))
-		free(iio_interface);
-	list_remove(desc->interfaces_list);
+	for (i = 0; i < desc->dev_count; i++) {
+		if (desc->interfaces[i])
+			iio_interface_free(desc->interfaces[i]);
+	}
+	free(desc->interfaces);
 
 	free(desc->iiod_ops);
 	tinyiiod_destroy(desc->iiod);
 
-	free(desc->xml_desc);
+	free(desc->bulk_req);
+	free(desc->bulk_entries);
 
 	if (desc->phy_type == USE_UART) {
 		uart_remove(desc->phy_desc);
 	}
 #ifdef ENABLE_IIO_NETWORK
 	else {
-		socket_remove(desc->server);
-		cb_remove(desc->sockets);
+		/* The server is the first socket */
+		for (i = 0; i < desc->nb_socks; i++)
+			socket_remove(desc->socks[i]);
+		free(desc->socks);
+		free(desc->poll_entries);
 	}
 #endif
 
@@ -46,6 +46,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <sys/types.h>
+#include "sample_conv.h"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -61,6 +62,7 @@ enum iio_chan_type {
 	IIO_ALTVOLTAGE,
 	IIO_ANGL_VEL,
 	IIO_TEMP,
+	IIO_ACCEL,
 	/* All new types must be added before this field */
 	IIO_LAST_TYPE
 };
@@ -104,23 +106,9 @@ struct iio_attribute {
 	/** Store function pointer */
 	ssize_t (*store)(void *device, char *buf, size_t len,
 			 const struct iio_ch_info *channel, intptr_t priv);
-};
-
-/**
- * @struct iio_channel
- * @brief Struct describing the scan type
- */
-struct scan_type {
-	/** 's' or 'u' to specify signed or unsigned */
-	char			sign;
-	/** Number of valid bits of data */
-	uint8_t 		realbits;
-	/** Realbits + padding */
-	uint8_t			storagebits;
-	/** Shift right by this before masking out realbits. */
-	uint8_t			shift;
-	/** True if big endian, false if little endian */
-	bool			is_big_endian;
+	/** Optional. Read the value as an integer, used by raw bulk reads */
+	int32_t (*show_raw)(void *device, int64_t *val,
+			    const struct iio_ch_info *channel, intptr_t priv);
 };
 
 /**
@@ -182,6 +170,12 @@ struct iio_device {
 	/** Read data from RAM to pbuf. It should be called after "transfer_dev_to_mem" */
 	ssize_t (*read_data)(void *dev_instance, char *pbuf, size_t offset,
 			     size_t bytes_count, uint32_t ch_mask);
+	/** Zero-copy alternative to "read_data". Set "*buff" to the address
+	 * of the "bytes_count" bytes found at "offset" in RAM. The data is
+	 * sent to the client directly from there. Used if "read_data" is NULL */
+	ssize_t (*get_read_data_ptr)(void *dev_instance, void **buff,
+				     size_t offset, size_t bytes_count,
+				     uint32_t ch_mask);
 	/** Transfer data from RAM to device */
 	ssize_t (*transfer_mem_to_dev)(void *dev_instance, size_t bytes_count,
 				       uint32_t ch_mask);
@@ -47,6 +47,15 @@
 
 #include <stdint.h>
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Data can be read from the socket or a connection can be accepted */
+#define SOCKET_POLL_IN		(1 << 0)
+/** The connection was closed or is in an error state */
+#define SOCKET_POLL_HUP		(1 << 1)
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -73,6 +82,17 @@ struct socket_address {
 	uint16_t	port;
 };
 
+/**
+ * @struct socket_poll_entry
+ * @brief Socket watched by \ref network_interface.socket_poll
+ */
+struct socket_poll_entry {
+	/** Socket id */
+	uint32_t	sock_id;
+	/** SOCKET_POLL_* events that occurred, set by socket_poll */
+	uint32_t	revents;
+};
+
 /**
  * @struct network_interface
  * @brief Interface that connect the data layer with the transport layer
@@ -218,6 +238,25 @@ struct network_interface {
 	 */
 	int32_t (*socket_accept)(void *net, uint32_t sock_id,
 				 uint32_t *client_socket_id);
+
+	/**
+	 * @brief Wait until at least one socket has events.
+	 *
+	 * Optional, if NULL the sockets have to be polled by the caller.
+	 * A listening socket signals SOCKET_POLL_IN when a connection can be
+	 * accepted.
+	 * @param net - Network interface
+	 * @param entries - Sockets to watch. The revents field is updated
+	 * @param nb_entries - Number of sockets
+	 * @param timeout_ms - Maximum time to wait, negative to wait
+	 * indefinitely
+	 * @return
+	 *  - Number of sockets with events : On success
+	 *  - 0 : On timeout
+	 *  - \ref Negative error code on failure
+	 */
+	int32_t (*socket_poll)(void *net, struct socket_poll_entry *entries,
+			       uint32_t nb_entries, int32_t timeout_ms);
 };
 
 #endif
@@ -466,3 +466,53 @@ int32_t socket_accept(struct tcp_socket_desc *desc,
 	return SUCCESS;
 }
 
+/**
+ * @brief Wait until at least one socket has data to be read or a connection
+ * to be accepted.
+ *
+ * All the sockets must use the same network interface.
+ * @param socks - Sockets to watch
+ * @param nb_socks - Number of sockets
+ * @param entries - Array of nb_socks elements, where the SOCKET_POLL_* events
+ * of each socket are stored
+ * @param timeout_ms - Maximum time to wait, negative to wait indefinitely
+ * @return
+ *  - Number of sockets with events : On success
+ *  - 0 : On timeout
+ *  - -ENOSYS : The network interface can't wait for events
+ *  - \ref Negative error code on failure
+ */
+int32_t socket_poll(struct tcp_socket_desc **socks, uint32_t nb_socks,
+		    struct socket_poll_entry *entries, int32_t timeout_ms)
+{
+	struct network_interface	*net;
+	uint32_t			i;
+
+	if (!socks || !nb_socks || !entries)
+		return -EINVAL;
+
+	net = socks[0]->net;
+	if (!net->socket_poll)
+		return -ENOSYS;
+
+	for (i = 0; i < nb_socks; i++) {
+		entries[i].sock_id = socks[i]->id;
+		entries[i].revents = 0;
+	}
+
+#ifndef DISABLE_SECURE_SOCKET
+	uint32_t nb_ready = 0;
+
+	/* Decrypted data may already wait in the TLS context */
+	for (i = 0; i < nb_socks; i++)
+		if (socks[i]->secure &&
+		    mbedtls_ssl_get_bytes_avail(&socks[i]->secure->ssl)) {
+			entries[i].revents = SOCKET_POLL_IN;
+			nb_ready++;
+		}
+	if (nb_ready)
+		return nb_ready;
+#endif /* DISABLE_SECURE_SOCKET */
+
+	return net->socket_poll(net->net, entries, nb_socks, timeout_ms);
+}
@@ -13,12 +13,14 @@ SRCS += $(PROJECT)/src/main.c
 SRCS += $(DRIVERS)/rf-transceiver/ad9361/ad9361_api.c			\
 	$(DRIVERS)/rf-transceiver/ad9361/ad9361.c			\
 	$(DRIVERS)/rf-transceiver/ad9361/ad9361_conv.c			\
+	$(DRIVERS)/rf-transceiver/ad9361/ad9361_hop.c			\
 	$(DRIVERS)/rf-transceiver/ad9361/ad9361_util.c
 SRCS += $(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.c			\
 	$(DRIVERS)/axi_core/axi_dac_core/axi_dac_core.c			\
 	$(DRIVERS)/axi_core/axi_dmac/axi_dmac.c				\
 	$(DRIVERS)/spi/spi.c						\
 	$(DRIVERS)/gpio/gpio.c						\
+	$(NO-OS)/util/crc8.c						\
 	$(NO-OS)/util/util.c
 SRCS +=	$(PLATFORM_DRIVERS)/axi_io.c
 SRCS +=	$(PLATFORM_DRIVERS)/$(PLATFORM)_spi.c				\
@@ -44,7 +46,8 @@ INCS += $(DRIVERS)/rf-transceiver/ad9361/common.h			\
 INCS += $(DRIVERS)/rf-transceiver/ad9361/ad9361.h			\
 	$(PROJECT)/src/parameters.h					\
 	$(DRIVERS)/rf-transceiver/ad9361/ad9361_util.h			\
-	$(DRIVERS)/rf-transceiver/ad9361/ad9361_api.h
+	$(DRIVERS)/rf-transceiver/ad9361/ad9361_api.h			\
+	$(DRIVERS)/rf-transceiver/ad9361/ad9361_hop.h
 INCS += $(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.h			\
 	$(DRIVERS)/axi_core/axi_dac_core/axi_dac_core.h			\
 	$(PLATFORM_DRIVERS)/irq_extra.h					\
@@ -62,6 +65,8 @@ INCS +=	$(INCLUDE)/axi_io.h						\
 	$(INCLUDE)/gpio.h						\
 	$(INCLUDE)/error.h						\
 	$(INCLUDE)/delay.h						\
+	$(INCLUDE)/crc8.h						\
+	$(INCLUDE)/crc_table.h						\
 	$(INCLUDE)/util.h
 ifeq (y,$(strip $(TINYIIOD)))
 INCS += $(INCLUDE)/xml.h						\
@@ -430,6 +430,9 @@ AD9361_InitParam default_init_param = {
 	&rx_adc_init,	// *rx_adc_init
 	&tx_dac_init,   // *tx_dac_init
 #endif
+	/* Digital interface tuning database */
+	0,		// dig_tune_board_id
+	NULL,	// *dig_tune_store
 };
 
 AD9361_RXFIRConfig rx_fir_config = {	// BPF PASSBAND 3/20 fs to 1/4 fs
@@ -685,9 +688,18 @@ int main(void)
 	if(status < 0)
 		return status;
 
-	axi_dmac_transfer_nonblocking(tx_dmac, DAC_DDR_BASEADDR, samples * 16);
+	status = axi_dmac_transfer_nonblocking(tx_dmac, DAC_DDR_BASEADDR,
+					       samples * 16);
+	if (status < 0) {
+		printf("axi_dmac_transfer tx error: %"PRIi32"\n", status);
+		return status;
+	}
 #endif
-	axi_dmac_transfer(rx_dmac, ADC_DDR_BASEADDR, samples * 16);
+	status = axi_dmac_transfer(rx_dmac, ADC_DDR_BASEADDR, samples * 16);
+	if (status < 0) {
+		printf("axi_dmac_transfer rx error: %"PRIi32"\n", status);
+		return status;
+	}
 #ifdef XILINX_PLATFORM
 #ifdef FMCOMMS5
 	Xil_DCacheInvalidateRange(ADC_DDR_BASEADDR, samples * 16);
@@ -1,9 +1,11 @@
 SRCS += $(NO-OS)/libraries/iio/iio.c
 SRCS += $(NO-OS)/libraries/iio/libtinyiiod/parser.c
 SRCS += $(NO-OS)/libraries/iio/libtinyiiod/tinyiiod.c
+SRCS += $(NO-OS)/util/sample_conv.c
 					
 INCS += $(NO-OS)/libraries/iio/iio.h
 INCS += $(NO-OS)/libraries/iio/iio_types.h
+INCS += $(NO-OS)/include/sample_conv.h
 INCS += $(NO-OS)/libraries/iio/libtinyiiod/tinyiiod.h
 INCS += $(NO-OS)/libraries/iio/libtinyiiod/tinyiiod-private.h
 INCS += $(NO-OS)/libraries/iio/libtinyiiod/compat.h
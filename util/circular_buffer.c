@@ -49,6 +49,18 @@
 #include "error.h"
 #include "util.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/*
+ * Accesses to the index owned by the other side of an SPSC buffer. The acquire
+ * load orders the data accesses after reading the index and the release store
+ * publishes the data accesses before updating it.
+ */
+#define CB_LOAD_ACQUIRE(ptr)		__atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define CB_STORE_RELEASE(ptr, val)	__atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -58,7 +70,8 @@
  * @brief Circular buffer pointer
  */
 struct cb_ptr {
-	/** Index of data in the buffer */
+	/** Index of data in the buffer. In SPSC mode it is a free running
+	 * counter, masked when converted to an address */
 	uint32_t	idx;
 	/** Counts the number of times idx exceeds the liniar buffer */
 	uint32_t	spin_count;
@@ -81,6 +94,10 @@ struct circular_buffer {
 	struct cb_ptr	write;
 	/** Read pointer */
 	struct cb_ptr	read;
+	/** Set for buffers created with cb_init_spsc() */
+	bool		spsc;
+	/** size - 1, used to mask the indexes in SPSC mode */
+	uint32_t	mask;
 };
 
 /******************************************************************************/
@@ -125,6 +142,39 @@ int32_t cb_init(struct circular_buffer **desc, uint32_t buff_size)
 	return SUCCESS;
 }
 
+/**
+ * @brief Create a lock-free single producer, single consumer buffer
+ *
+ * One writer and one reader can access the buffer concurrently, for example
+ * an interrupt handler and the main loop, without a critical section.
+ * Unlike the buffers created with cb_init(), data is never overwritten: when
+ * the buffer is full, writes wait (or cb_prepare_async_write() returns
+ * -EAGAIN) until the reader frees space.
+ *
+ * @param desc - Where to store the circular buffer reference
+ * @param buff_size - Buffer size, must be a power of two
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : Wrong parameters used
+ *  - -ENOMEM : Memory allocation failure
+ */
+int32_t cb_init_spsc(struct circular_buffer **desc, uint32_t buff_size)
+{
+	int32_t ret;
+
+	if (!buff_size || (buff_size & (buff_size - 1)))
+		return -EINVAL;
+
+	ret = cb_init(desc, buff_size);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	(*desc)->spsc = true;
+	(*desc)->mask = buff_size - 1;
+
+	return SUCCESS;
+}
+
 /**
  * @brief Free the resources allocated for the circular buffer structure
  * @param desc - Circular buffer reference
@@ -160,6 +210,12 @@ int32_t cb_size(struct circular_buffer *desc, uint32_t *size)
 	if (!desc || !size)
 		return -EINVAL;
 
+	if (desc->spsc) {
+		*size = CB_LOAD_ACQUIRE(&desc->write.idx) -
+			CB_LOAD_ACQUIRE(&desc->read.idx);
+		return SUCCESS;
+	}
+
 	if (desc->write.spin_count > desc->read.spin_count)
 		nb_spins = desc->write.spin_count - desc->read.spin_count;
 	else
@@ -180,6 +236,43 @@ int32_t cb_size(struct circular_buffer *desc, uint32_t *size)
 	return SUCCESS;
 }
 
+/*
+ * cb_prepare_async_operation() for SPSC buffers. Only the index owned by the
+ * other side is loaded with acquire semantics.
+ */
+static int32_t cb_spsc_prepare_async_operation(struct circular_buffer *desc,
+		uint32_t requested_size,
+		void **buff,
+		uint32_t *raw_size_available,
+		bool is_read)
+{
+	struct cb_ptr	*ptr;
+	uint32_t	available_size;
+	uint32_t	offset;
+
+	ptr = is_read ? &desc->read : &desc->write;
+	if (ptr->async_started)
+		return -EBUSY;
+
+	if (is_read)
+		available_size = CB_LOAD_ACQUIRE(&desc->write.idx) - ptr->idx;
+	else
+		available_size = desc->size -
+				 (ptr->idx - CB_LOAD_ACQUIRE(&desc->read.idx));
+
+	requested_size = min(requested_size, available_size);
+	if (!requested_size)
+		return -EAGAIN;
+
+	offset = ptr->idx & desc->mask;
+	ptr->async_size = min(requested_size, desc->size - offset);
+	*raw_size_available = ptr->async_size;
+	*buff = (void *)(desc->buff + offset);
+	ptr->async_started = true;
+
+	return SUCCESS;
+}
+
 /*
  * Functionality described at cb_prepare_async_write/read having the is_read
  * parameter to specifiy if it is a read or write operation
@@ -197,6 +290,11 @@ static int32_t cb_prepare_async_operation(struct circular_buffer *desc,
 	if (!desc || !buff || !raw_size_available)
 		return -EINVAL;
 
+	if (desc->spsc)
+		return cb_spsc_prepare_async_operation(desc, requested_size,
+						       buff, raw_size_available,
+						       is_read);
+
 	ret = SUCCESS;
 	/* Select if read or write index will be updated */
 	ptr = is_read ? &desc->read : &desc->write;
@@ -253,6 +351,15 @@ static int32_t cb_end_async_operation(struct circular_buffer *desc,
 	if (!ptr->async_started)
 		return FAILURE;
 
+	if (desc->spsc) {
+		ptr->async_started = false;
+		/* Publish the data before the other side sees the new index */
+		CB_STORE_RELEASE(&ptr->idx, ptr->idx + ptr->async_size);
+		ptr->async_size = 0;
+
+		return SUCCESS;
+	}
+
 	/* Update pointer value */
 	new_val = ptr->idx + ptr->async_size;
 	if (new_val >= desc->size) {
@@ -382,6 +489,32 @@ int32_t cb_end_async_read(struct circular_buffer *desc)
 }
 /** @} */
 
+/**
+ * @brief Abort an asynchronous write
+ *
+ * Nothing is added to the buffer, for example because the transfer filling
+ * the buffer returned by cb_prepare_async_write() failed.
+ *
+ * @param desc - Circular buffer reference
+ * @return
+ *  - \ref SUCCESS   - No errors
+ *  - \ref FAILURE   - Asynchronous transaction not started
+ *  - -EINVAL        - Wrong parameters used
+ */
+int32_t cb_abort_async_write(struct circular_buffer *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->write.async_started)
+		return FAILURE;
+
+	desc->write.async_size = 0;
+	desc->write.async_started = false;
+
+	return SUCCESS;
+}
+
 /**
  * @brief Write data to the buffer (Blocking)
  * @param desc - Circular buffer reference
@@ -100,3 +100,36 @@ uint16_t crc16(const uint16_t * table, const uint8_t *pdata, size_t nbytes,
 
 	return crc;
 }
+
+/***************************************************************************//**
+ * @brief Computes the CRC-16 over a buffer of data, CRC_SLICE_NUM bytes at a
+ *        time.
+ *
+ * @param table     - Sliced CRC-16 lookup table for the desired polynomial, as
+ *                    defined by DECLARE_CRC16_SLICE_TABLE().
+ * @param pdata     - Pointer to data buffer.
+ * @param nbytes    - Number of bytes to compute the CRC-16 over.
+ * @param crc       - Initial value for the CRC-16 computation. Can be used to
+ *                    cascade calls to this function by providing a previous
+ *                    output of this function as the crc parameter.
+ *
+ * @return crc      - Computed CRC-16 value.
+*******************************************************************************/
+uint16_t crc16_slice(const uint16_t table[][CRC16_TABLE_SIZE],
+		     const uint8_t *pdata, size_t nbytes, uint16_t crc)
+{
+	unsigned int i;
+	uint16_t val;
+
+	while (nbytes >= CRC_SLICE_NUM) {
+		val = table[CRC_SLICE_NUM - 1][(crc >> 8) ^ pdata[0]] ^
+		      table[CRC_SLICE_NUM - 2][(crc & 0xff) ^ pdata[1]];
+		for (i = 2; i < CRC_SLICE_NUM; i++)
+			val ^= table[CRC_SLICE_NUM - 1 - i][pdata[i]];
+		crc = val;
+		pdata += CRC_SLICE_NUM;
+		nbytes -= CRC_SLICE_NUM;
+	}
+
+	return crc16(table[0], pdata, nbytes, crc);
+}
@@ -101,3 +101,38 @@ uint32_t crc24(const uint32_t * table, const uint8_t *pdata, size_t nbytes,
 
 	return (crc & 0xffffff);
 }
+
+/***************************************************************************//**
+ * @brief Computes the CRC-24 over a buffer of data, CRC_SLICE_NUM bytes at a
+ *        time.
+ *
+ * @param table     - Sliced CRC-24 lookup table for the desired polynomial, as
+ *                    defined by DECLARE_CRC24_SLICE_TABLE().
+ * @param pdata     - Pointer to data buffer.
+ * @param nbytes    - Number of bytes to compute the CRC-24 over.
+ * @param crc       - Initial value for the CRC-24 computation. Can be used to
+ *                    cascade calls to this function by providing a previous
+ *                    output of this function as the crc parameter.
+ *
+ * @return crc      - Computed CRC-24 value.
+*******************************************************************************/
+uint32_t crc24_slice(const uint32_t table[][CRC24_TABLE_SIZE],
+		     const uint8_t *pdata, size_t nbytes, uint32_t crc)
+{
+	unsigned int i;
+	uint32_t val;
+
+	crc &= 0xffffff;
+	while (nbytes >= CRC_SLICE_NUM) {
+		val = table[CRC_SLICE_NUM - 1][(crc >> 16) ^ pdata[0]] ^
+		      table[CRC_SLICE_NUM - 2][((crc >> 8) & 0xff) ^ pdata[1]] ^
+		      table[CRC_SLICE_NUM - 3][(crc & 0xff) ^ pdata[2]];
+		for (i = 3; i < CRC_SLICE_NUM; i++)
+			val ^= table[CRC_SLICE_NUM - 1 - i][pdata[i]];
+		crc = val;
+		pdata += CRC_SLICE_NUM;
+		nbytes -= CRC_SLICE_NUM;
+	}
+
+	return crc24(table[0], pdata, nbytes, crc);
+}
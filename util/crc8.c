@@ -98,3 +98,35 @@ uint8_t crc8(const uint8_t * table, const uint8_t *pdata, size_t nbytes,
 
 	return crc;
 }
+
+/***************************************************************************//**
+ * @brief Computes the CRC-8 over a buffer of data, CRC_SLICE_NUM bytes at a
+ *        time.
+ *
+ * @param table     - Sliced CRC-8 lookup table for the desired polynomial, as
+ *                    defined by DECLARE_CRC8_SLICE_TABLE().
+ * @param pdata     - Pointer to 8-bit data buffer.
+ * @param nbytes    - Number of bytes to compute the CRC-8 over.
+ * @param crc       - Initial value for the CRC-8 computation. Can be used to
+ *                    cascade calls to this function by providing a previous
+ *                    output of this function as the crc parameter.
+ *
+ * @return crc      - Computed CRC-8 value.
+*******************************************************************************/
+uint8_t crc8_slice(const uint8_t table[][CRC8_TABLE_SIZE],
+		   const uint8_t *pdata, size_t nbytes, uint8_t crc)
+{
+	unsigned int i;
+	uint8_t val;
+
+	while (nbytes >= CRC_SLICE_NUM) {
+		val = table[CRC_SLICE_NUM - 1][crc ^ pdata[0]];
+		for (i = 1; i < CRC_SLICE_NUM; i++)
+			val ^= table[CRC_SLICE_NUM - 1 - i][pdata[i]];
+		crc = val;
+		pdata += CRC_SLICE_NUM;
+		nbytes -= CRC_SLICE_NUM;
+	}
+
+	return crc8(table[0], pdata, nbytes, crc);
+}
@@ -0,0 +1,546 @@
+/***************************************************************************//**
+ *   @file   regmap.c
+ *   @brief  Register map cache implementation
+ *   @author Mihail Chindris (mihail.chindris@analog.com)
+********************************************************************************
+ *   @copyright
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+#include "regmap.h"
+#include "error.h"
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** The cached value matches the device */
+#define REGMAP_VALID		BIT(0)
+/** The cached value was not written to the device yet */
+#define REGMAP_DIRTY		BIT(1)
+/** The register is never cached */
+#define REGMAP_VOLATILE		BIT(2)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct regmap
+ * @brief Register map descriptor
+ */
+struct regmap {
+	/** Highest register address of the device */
+	uint32_t	max_register;
+	/** Maximum number of registers in one bulk transaction */
+	uint32_t	max_burst;
+	/** Device specific context passed to the bus callbacks */
+	void		*ctx;
+	/** Read one register from the device */
+	int32_t (*reg_read)(void *ctx, uint32_t reg, uint32_t *val);
+	/** Write one register of the device */
+	int32_t (*reg_write)(void *ctx, uint32_t reg, uint32_t val);
+	/** Read consecutive registers in a single transaction */
+	int32_t (*reg_read_bulk)(void *ctx, uint32_t reg, uint32_t *vals,
+				 uint32_t count);
+	/** Write consecutive registers in a single transaction */
+	int32_t (*reg_write_bulk)(void *ctx, uint32_t reg, const uint32_t *vals,
+				  uint32_t count);
+	/** Shadow registers */
+	uint32_t	*cache;
+	/** REGMAP_VALID, REGMAP_DIRTY and REGMAP_VOLATILE flags per register */
+	uint8_t		*flags;
+	/** Set if writes are only stored in the cache until regmap_sync() */
+	bool		cache_only;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Check if a register value can be served from the cache
+ * @param desc - Register map reference
+ * @param reg - Register address
+ * @return true if the cached value is up to date
+ */
+static inline bool regmap_cached(struct regmap *desc, uint32_t reg)
+{
+	return (desc->flags[reg] & (REGMAP_VALID | REGMAP_VOLATILE)) ==
+	       REGMAP_VALID;
+}
+
+/**
+ * @brief Create a register map
+ *
+ * The cache starts empty, every register is read from the device on first
+ * access.
+ * @param desc - Where to store the register map reference
+ * @param param - Initialization parameters
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : Invalid parameters
+ *  - -ENOMEM : Memory allocation failure
+ */
+int32_t regmap_init(struct regmap **desc,
+		    const struct regmap_init_param *param)
+{
+	struct regmap	*ldesc;
+	uint32_t	i, reg;
+
+	if (!desc || !param || !param->reg_read || !param->reg_write)
+		return -EINVAL;
+
+	ldesc = (struct regmap *)calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return -ENOMEM;
+
+	ldesc->cache = calloc(param->max_register + 1, sizeof(*ldesc->cache));
+	ldesc->flags = calloc(param->max_register + 1, sizeof(*ldesc->flags));
+	if (!ldesc->cache || !ldesc->flags) {
+		regmap_remove(ldesc);
+		return -ENOMEM;
+	}
+
+	ldesc->max_register = param->max_register;
+	ldesc->max_burst = param->max_burst;
+	ldesc->ctx = param->ctx;
+	ldesc->reg_read = param->reg_read;
+	ldesc->reg_write = param->reg_write;
+	ldesc->reg_read_bulk = param->reg_read_bulk;
+	ldesc->reg_write_bulk = param->reg_write_bulk;
+
+	for (i = 0; i < param->nb_volatile_ranges; i++)
+		for (reg = param->volatile_ranges[i].first;
+		     reg <= min(param->volatile_ranges[i].last,
+				param->max_register); reg++)
+			ldesc->flags[reg] = REGMAP_VOLATILE;
+
+	*desc = ldesc;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated for the register map
+ *
+ * Pending writes are dropped, call regmap_sync() first to keep them.
+ * @param desc - Register map reference
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : Invalid parameters
+ */
+int32_t regmap_remove(struct regmap *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	free(desc->cache);
+	free(desc->flags);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read a register
+ *
+ * Non volatile registers are read from the device only once.
+ * @param desc - Register map reference
+ * @param reg - Register address
+ * @param val - Where to store the register value
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : Invalid parameters
+ *  - Bus error code : Otherwise
+ */
+int32_t regmap_read(struct regmap *desc, uint32_t reg, uint32_t *val)
+{
+	int32_t ret;
+
+	if (!desc || !val || reg > desc->max_register)
+		return -EINVAL;
+
+	if (!regmap_cached(desc, reg)) {
+		ret = desc->reg_read(desc->ctx, reg, val);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		if (desc->flags[reg] & REGMAP_VOLATILE)
+			return SUCCESS;
+
+		desc->cache[reg] = *val;
+		desc->flags[reg] |= REGMAP_VALID;
+	}
+
+	*val = desc->cache[reg];
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Write a register
+ *
+ * Writes that do not change the cached value are skipped. In cache only mode,
+ * non volatile registers are only marked dirty. Volatile registers are always
+ * written, after the pending writes, to keep the access order.
+ * @param desc - Register map reference
+ * @param reg - Register address
+ * @param val - Register value
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : Invalid parameters
+ *  - Bus error code : Otherwise
+ */
+int32_t regmap_write(struct regmap *desc, uint32_t reg, uint32_t val)
+{
+	int32_t ret;
+
+	if (!desc || reg > desc->max_register)
+		return -EINVAL;
+
+	if (desc->flags[reg] & REGMAP_VOLATILE) {
+		if (desc->cache_only) {
+			ret = regmap_sync(desc);
+			if (IS_ERR_VALUE(ret))
+				return ret;
+		}
+
+		return desc->reg_write(desc->ctx, reg, val);
+	}
+
+	if (regmap_cached(desc, reg) && desc->cache[reg] == val)
+		return SUCCESS;
+
+	if (desc->cache_only) {
+		desc->cache[reg] = val;
+		desc->flags[reg] |= REGMAP_VALID | REGMAP_DIRTY;
+
+		return SUCCESS;
+	}
+
+	ret = desc->reg_write(desc->ctx, reg, val);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	desc->cache[reg] = val;
+	desc->flags[reg] |= REGMAP_VALID;
+	desc->flags[reg] &= ~REGMAP_DIRTY;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Update a register field
+ *
+ * The read part of the read-modify-write is served from the cache.
+ * @param desc - Register map reference
+ * @param reg - Register address
+ * @param mask - Bits to update
+ * @param val - New value of the bits in mask
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : Invalid parameters
+ *  - Bus error code : Otherwise
+ */
+int32_t regmap_update_bits(struct regmap *desc, uint32_t reg, uint32_t mask,
+			   uint32_t val)
+{
+	uint32_t	old;
+	int32_t		ret;
+
+	ret = regmap_read(desc, reg, &old);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	return regmap_write(desc, reg, (old & ~mask) | (val & mask));
+}
+
+/**
+ * @brief Read consecutive registers
+ *
+ * If any register in the range is not cached, the range is read with bulk
+ * transactions when the bus supports them.
+ * @param desc - Register map reference
+ * @param reg - First register address
+ * @param vals - Where to store the register values
+ * @param count - Number of registers
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : Invalid parameters
+ *  - Bus error code : Otherwise
+ */
+int32_t regmap_bulk_read(struct regmap *desc, uint32_t reg, uint32_t *vals,
+			 uint32_t count)
+{
+	uint32_t	i, chunk;
+	int32_t		ret;
+
+	if (!desc || !vals || !count || reg > desc->max_register ||
+	    count - 1 > desc->max_register - reg)
+		return -EINVAL;
+
+	for (i = 0; i < count; i++)
+		if (!regmap_cached(desc, reg + i))
+			break;
+
+	if (i == count) {
+		memcpy(vals, &desc->cache[reg], count * sizeof(*vals));
+		return SUCCESS;
+	}
+
+	if (!desc->reg_read_bulk) {
+		for (i = 0; i < count; i++) {
+			ret = regmap_read(desc, reg + i, &vals[i]);
+			if (IS_ERR_VALUE(ret))
+				return ret;
+		}
+
+		return SUCCESS;
+	}
+
+	for (i = 0; i < count; i += chunk) {
+		chunk = count - i;
+		if (desc->max_burst)
+			chunk = min(chunk, desc->max_burst);
+		ret = desc->reg_read_bulk(desc->ctx, reg + i, &vals[i], chunk);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (desc->flags[reg + i] & REGMAP_VOLATILE)
+			continue;
+		/* Pending writes are newer than the device content */
+		if (desc->flags[reg + i] & REGMAP_DIRTY) {
+			vals[i] = desc->cache[reg + i];
+			continue;
+		}
+		desc->cache[reg + i] = vals[i];
+		desc->flags[reg + i] |= REGMAP_VALID;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Write a group of dirty registers
+ * @param desc - Register map reference
+ * @param reg - First register address
+ * @param count - Number of registers
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - Bus error code : Otherwise
+ */
+static int32_t regmap_write_run(struct regmap *desc, uint32_t reg,
+				uint32_t count)
+{
+	uint32_t	i;
+	int32_t		ret;
+
+	if (count > 1 && desc->reg_write_bulk) {
+		ret = desc->reg_write_bulk(desc->ctx, reg, &desc->cache[reg],
+					   count);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	} else {
+		for (i = reg; i < reg + count; i++) {
+			if (!(desc->flags[i] & REGMAP_DIRTY))
+				continue;
+			ret = desc->reg_write(desc->ctx, i, desc->cache[i]);
+			if (IS_ERR_VALUE(ret))
+				return ret;
+		}
+	}
+
+	for (i = reg; i < reg + count; i++)
+		desc->flags[i] &= ~REGMAP_DIRTY;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Write consecutive registers
+ *
+ * In cache only mode, the registers are written on the next regmap_sync().
+ * @param desc - Register map reference
+ * @param reg - First register address
+ * @param vals - Register values
+ * @param count - Number of registers
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : Invalid parameters
+ *  - Bus error code : Otherwise
+ */
+int32_t regmap_bulk_write(struct regmap *desc, uint32_t reg,
+			  const uint32_t *vals, uint32_t count)
+{
+	uint32_t	i, chunk;
+	int32_t		ret;
+	bool		has_volatile = false;
+
+	if (!desc || !vals || !count || reg > desc->max_register ||
+	    count - 1 > desc->max_register - reg)
+		return -EINVAL;
+
+	for (i = 0; i < count; i++)
+		if (desc->flags[reg + i] & REGMAP_VOLATILE)
+			has_volatile = true;
+
+	if (desc->cache_only || has_volatile || !desc->reg_write_bulk) {
+		for (i = 0; i < count; i++) {
+			ret = regmap_write(desc, reg + i, vals[i]);
+			if (IS_ERR_VALUE(ret))
+				return ret;
+		}
+
+		return SUCCESS;
+	}
+
+	for (i = 0; i < count; i++) {
+		desc->cache[reg + i] = vals[i];
+		desc->flags[reg + i] |= REGMAP_VALID | REGMAP_DIRTY;
+	}
+
+	for (i = 0; i < count; i += chunk) {
+		chunk = count - i;
+		if (desc->max_burst)
+			chunk = min(chunk, desc->max_burst);
+		ret = regmap_write_run(desc, reg + i, chunk);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enable or disable the cache only mode
+ *
+ * While enabled, writes to non volatile registers are coalesced in the cache.
+ * Disabling it flushes the pending writes.
+ * @param desc - Register map reference
+ * @param enable - Cache only mode state
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : Invalid parameters
+ *  - Bus error code : Otherwise
+ */
+int32_t regmap_cache_only(struct regmap *desc, bool enable)
+{
+	if (!desc)
+		return -EINVAL;
+
+	desc->cache_only = enable;
+	if (!enable)
+		return regmap_sync(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Write the pending registers to the device
+ *
+ * Dirty registers with adjacent addresses are written with one bulk
+ * transaction. When the bus supports bulk writes, a run may also include the
+ * clean cached registers found between two dirty ones.
+ * @param desc - Register map reference
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : Invalid parameters
+ *  - Bus error code : Otherwise
+ */
+int32_t regmap_sync(struct regmap *desc)
+{
+	uint32_t	reg, end, last;
+	int32_t		ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	reg = 0;
+	while (reg <= desc->max_register) {
+		if (!(desc->flags[reg] & REGMAP_DIRTY)) {
+			reg++;
+			continue;
+		}
+
+		last = reg;
+		for (end = reg + 1; end <= desc->max_register; end++) {
+			if (desc->max_burst && end - reg >= desc->max_burst)
+				break;
+			if (desc->flags[end] & REGMAP_DIRTY)
+				last = end;
+			else if (!desc->reg_write_bulk ||
+				 !regmap_cached(desc, end))
+				break;
+		}
+
+		ret = regmap_write_run(desc, reg, last - reg + 1);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+
+		reg = last + 1;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Drop the cached values
+ *
+ * Must be called after the device is reset. Pending writes are dropped.
+ * @param desc - Register map reference
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : Invalid parameters
+ */
+int32_t regmap_invalidate(struct regmap *desc)
+{
+	uint32_t reg;
+
+	if (!desc)
+		return -EINVAL;
+
+	for (reg = 0; reg <= desc->max_register; reg++)
+		desc->flags[reg] &= REGMAP_VOLATILE;
+
+	return SUCCESS;
+}
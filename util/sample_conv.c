@@ -0,0 +1,475 @@
+/***************************************************************************//**
+ *   @file   sample_conv.c
+ *   @brief  Sample format conversion library implementation
+ *   @author Mihail Chindris (mihail.chindris@analog.com)
+********************************************************************************
+ *   @copyright
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <string.h>
+#include "sample_conv.h"
+#include "error.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SAMPLE_CONV_SIMD
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SAMPLE_CONV_SIMD
+#endif
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Samples converted at once when an intermediate buffer is needed */
+#define SAMPLE_CONV_CHUNK	64
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define SAMPLE_CONV_HOST_BE	true
+#else
+#define SAMPLE_CONV_HOST_BE	false
+#endif
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sample_conv_vec_param
+ * @brief Parameters of the vector kernels, for 16 bits storage
+ */
+struct sample_conv_vec_param {
+	/** Swap the bytes of each sample */
+	bool		swap;
+	/** Sign extend, otherwise mask */
+	bool		is_signed;
+	/** Right shift applied first */
+	int16_t		shift;
+	/** 16 - realbits */
+	int16_t		ext;
+	/** Mask of the realbits */
+	uint16_t	mask;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Check that a scan type can be converted.
+ * @param type - Scan type.
+ * @return SUCCESS in case of success, -EINVAL otherwise.
+ */
+static int32_t sample_conv_check(const struct scan_type *type)
+{
+	if (!type || !type->realbits || type->realbits > 32 ||
+	    !type->storagebits || type->storagebits > 32 ||
+	    type->realbits + type->shift > type->storagebits)
+		return -EINVAL;
+
+	/* Packed samples are only defined as a big endian bit stream */
+	if ((type->storagebits % 8) && !type->is_big_endian)
+		return -EINVAL;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Apply the shift, mask and sign of a scan type to a stored value.
+ * @param type - Scan type.
+ * @param raw - Stored value.
+ * @return Converted value.
+ */
+static inline int32_t sample_conv_extract(const struct scan_type *type,
+		uint32_t raw)
+{
+	raw >>= type->shift;
+	if (type->sign == 's')
+		return sample_conv_sign_extend(raw, type->realbits);
+	if (type->realbits < 32)
+		raw &= (1u << type->realbits) - 1;
+
+	return (int32_t)raw;
+}
+
+/**
+ * @brief Portable conversion of any scan type.
+ * @param type - Scan type.
+ * @param src - Stored samples.
+ * @param first - Index of the first sample to be converted.
+ * @param dst - Where the samples are stored.
+ * @param nb_samples - Number of samples to be converted.
+ */
+static void sample_conv_portable(const struct scan_type *type,
+				 const uint8_t *src, uint32_t first,
+				 int32_t *dst, uint32_t nb_samples)
+{
+	uint32_t bytes = type->storagebits / 8;
+	uint64_t bit_pos;
+	uint32_t nb_bits;
+	uint64_t acc;
+	uint32_t raw;
+	uint32_t i;
+	uint8_t j;
+
+	if (type->storagebits % 8) {
+		/* Packed samples, most significant bit first */
+		bit_pos = (uint64_t)first * type->storagebits;
+		src += bit_pos / 8;
+		nb_bits = 0;
+		acc = 0;
+		if (bit_pos % 8) {
+			acc = *src++ & (0xFF >> (bit_pos % 8));
+			nb_bits = 8 - bit_pos % 8;
+		}
+		for (i = 0; i < nb_samples; i++) {
+			while (nb_bits < type->storagebits) {
+				acc = (acc << 8) | *src++;
+				nb_bits += 8;
+			}
+			nb_bits -= type->storagebits;
+			raw = acc >> nb_bits;
+			acc &= ((uint64_t)1 << nb_bits) - 1;
+			if (type->storagebits < 32)
+				raw &= (1u << type->storagebits) - 1;
+			dst[i] = sample_conv_extract(type, raw);
+		}
+
+		return;
+	}
+
+	src += first * bytes;
+	for (i = 0; i < nb_samples; i++, src += bytes) {
+		raw = 0;
+		if (type->is_big_endian)
+			for (j = 0; j < bytes; j++)
+				raw = (raw << 8) | src[j];
+		else
+			for (j = bytes; j > 0; j--)
+				raw = (raw << 8) | src[j - 1];
+		dst[i] = sample_conv_extract(type, raw);
+	}
+}
+
+#ifdef SAMPLE_CONV_SIMD
+
+#if defined(__SSE2__)
+
+/* Load 8 samples of 16 bits and apply the scan type */
+static inline __m128i sample_conv_vec_load(const uint8_t *src,
+		const struct sample_conv_vec_param *p)
+{
+	__m128i v = _mm_loadu_si128((const __m128i *)src);
+	__m128i ext = _mm_cvtsi32_si128(p->ext);
+
+	if (p->swap)
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+	v = _mm_srl_epi16(v, _mm_cvtsi32_si128(p->shift));
+	if (p->is_signed)
+		return _mm_sra_epi16(_mm_sll_epi16(v, ext), ext);
+
+	return _mm_and_si128(v, _mm_set1_epi16(p->mask));
+}
+
+static inline void sample_conv_vec_store16(int16_t *dst, __m128i v)
+{
+	_mm_storeu_si128((__m128i *)dst, v);
+}
+
+/* Widen the 8 samples to 32 bits */
+static inline void sample_conv_vec_widen(__m128i v, bool is_signed,
+		__m128i *lo, __m128i *hi)
+{
+	if (is_signed) {
+		*lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+		*hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+	} else {
+		*lo = _mm_unpacklo_epi16(v, _mm_setzero_si128());
+		*hi = _mm_unpackhi_epi16(v, _mm_setzero_si128());
+	}
+}
+
+static inline void sample_conv_vec_store32(int32_t *dst, __m128i v,
+		bool is_signed)
+{
+	__m128i lo, hi;
+
+	sample_conv_vec_widen(v, is_signed, &lo, &hi);
+	_mm_storeu_si128((__m128i *)dst, lo);
+	_mm_storeu_si128((__m128i *)(dst + 4), hi);
+}
+
+static inline void sample_conv_vec_store_float(float *dst, __m128i v,
+		bool is_signed, float scale)
+{
+	__m128 s = _mm_set1_ps(scale);
+	__m128i lo, hi;
+
+	sample_conv_vec_widen(v, is_signed, &lo, &hi);
+	_mm_storeu_ps(dst, _mm_mul_ps(_mm_cvtepi32_ps(lo), s));
+	_mm_storeu_ps(dst + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), s));
+}
+
+#else /* NEON */
+
+/* Load 8 samples of 16 bits and apply the scan type */
+static inline int16x8_t sample_conv_vec_load(const uint8_t *src,
+		const struct sample_conv_vec_param *p)
+{
+	uint8x16_t b = vld1q_u8(src);
+	uint16x8_t v;
+
+	if (p->swap)
+		b = vrev16q_u8(b);
+	v = vshlq_u16(vreinterpretq_u16_u8(b), vdupq_n_s16(-p->shift));
+	if (p->is_signed)
+		return vshlq_s16(vshlq_s16(vreinterpretq_s16_u16(v),
+					   vdupq_n_s16(p->ext)),
+				 vdupq_n_s16(-p->ext));
+
+	return vreinterpretq_s16_u16(vandq_u16(v, vdupq_n_u16(p->mask)));
+}
+
+static inline void sample_conv_vec_store16(int16_t *dst, int16x8_t v)
+{
+	vst1q_s16(dst, v);
+}
+
+/* Widen the 8 samples to 32 bits */
+static inline void sample_conv_vec_widen(int16x8_t v, bool is_signed,
+		int32x4_t *lo, int32x4_t *hi)
+{
+	uint16x8_t u = vreinterpretq_u16_s16(v);
+
+	if (is_signed) {
+		*lo = vmovl_s16(vget_low_s16(v));
+		*hi = vmovl_s16(vget_high_s16(v));
+	} else {
+		*lo = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(u)));
+		*hi = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(u)));
+	}
+}
+
+static inline void sample_conv_vec_store32(int32_t *dst, int16x8_t v,
+		bool is_signed)
+{
+	int32x4_t lo, hi;
+
+	sample_conv_vec_widen(v, is_signed, &lo, &hi);
+	vst1q_s32(dst, lo);
+	vst1q_s32(dst + 4, hi);
+}
+
+static inline void sample_conv_vec_store_float(float *dst, int16x8_t v,
+		bool is_signed, float scale)
+{
+	int32x4_t lo, hi;
+
+	sample_conv_vec_widen(v, is_signed, &lo, &hi);
+	vst1q_f32(dst, vmulq_n_f32(vcvtq_f32_s32(lo), scale));
+	vst1q_f32(dst + 4, vmulq_n_f32(vcvtq_f32_s32(hi), scale));
+}
+
+#endif
+
+/**
+ * @brief Set up the vector kernels for a scan type.
+ * @param type - Scan type.
+ * @param p - Kernel parameters.
+ * @return true if the vector kernels can convert this scan type.
+ */
+static bool sample_conv_vec_init(const struct scan_type *type,
+				 struct sample_conv_vec_param *p)
+{
+	if (type->storagebits != 16)
+		return false;
+
+	p->swap = type->is_big_endian != SAMPLE_CONV_HOST_BE;
+	p->is_signed = type->sign == 's';
+	p->shift = type->shift;
+	p->ext = 16 - type->realbits;
+	p->mask = 0xFFFF >> p->ext;
+
+	return true;
+}
+
+#endif /* SAMPLE_CONV_SIMD */
+
+/**
+ * @brief Number of bytes used by a number of samples.
+ * @param type - Scan type.
+ * @param nb_samples - Number of samples.
+ * @return Number of bytes, rounded up for packed samples.
+ */
+uint32_t sample_conv_bytes(const struct scan_type *type, uint32_t nb_samples)
+{
+	return ((uint64_t)nb_samples * type->storagebits + 7) / 8;
+}
+
+/**
+ * @brief Unpack samples to 32 bits integers.
+ *
+ * Each sample is loaded with the endianness of the scan type, shifted right,
+ * masked to realbits and sign extended if the scan type is signed.
+ * @param type - Scan type of the samples.
+ * @param src - Stored samples.
+ * @param dst - Where the samples are stored.
+ * @param nb_samples - Number of samples.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sample_conv_unpack(const struct scan_type *type, const void *src,
+			   int32_t *dst, uint32_t nb_samples)
+{
+	const uint8_t *s = src;
+	uint32_t i = 0;
+	int32_t ret;
+#ifdef SAMPLE_CONV_SIMD
+	struct sample_conv_vec_param p;
+#endif
+
+	ret = sample_conv_check(type);
+	if (ret != SUCCESS)
+		return ret;
+
+#ifdef SAMPLE_CONV_SIMD
+	if (sample_conv_vec_init(type, &p))
+		for (; i + 8 <= nb_samples; i += 8)
+			sample_conv_vec_store32(dst + i,
+						sample_conv_vec_load(s + 2 * i, &p),
+						p.is_signed);
+#endif
+	sample_conv_portable(type, s, i, dst + i, nb_samples - i);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Unpack samples of up to 16 valid bits to 16 bits integers.
+ *
+ * Unsigned samples of 16 valid bits keep their bit pattern.
+ * @param type - Scan type of the samples.
+ * @param src - Stored samples.
+ * @param dst - Where the samples are stored.
+ * @param nb_samples - Number of samples.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sample_conv_unpack16(const struct scan_type *type, const void *src,
+			     int16_t *dst, uint32_t nb_samples)
+{
+	int32_t chunk[SAMPLE_CONV_CHUNK];
+	const uint8_t *s = src;
+	uint32_t i = 0;
+	uint32_t j, n;
+	int32_t ret;
+#ifdef SAMPLE_CONV_SIMD
+	struct sample_conv_vec_param p;
+#endif
+
+	ret = sample_conv_check(type);
+	if (ret != SUCCESS)
+		return ret;
+	if (type->realbits > 16)
+		return -EINVAL;
+
+#ifdef SAMPLE_CONV_SIMD
+	if (sample_conv_vec_init(type, &p))
+		for (; i + 8 <= nb_samples; i += 8)
+			sample_conv_vec_store16(dst + i,
+						sample_conv_vec_load(s + 2 * i, &p));
+#endif
+	for (; i < nb_samples; i += n) {
+		n = nb_samples - i;
+		if (n > SAMPLE_CONV_CHUNK)
+			n = SAMPLE_CONV_CHUNK;
+		sample_conv_portable(type, s, i, chunk, n);
+		for (j = 0; j < n; j++)
+			dst[i + j] = (int16_t)chunk[j];
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Unpack samples and multiply them by a scale.
+ * @param type - Scan type of the samples.
+ * @param src - Stored samples.
+ * @param dst - Where the scaled samples are stored.
+ * @param nb_samples - Number of samples.
+ * @param scale - Value of one LSB.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sample_conv_to_float(const struct scan_type *type, const void *src,
+			     float *dst, uint32_t nb_samples, float scale)
+{
+	int32_t chunk[SAMPLE_CONV_CHUNK];
+	const uint8_t *s = src;
+	uint32_t i = 0;
+	uint32_t j, n;
+	int32_t ret;
+#ifdef SAMPLE_CONV_SIMD
+	struct sample_conv_vec_param p;
+#endif
+
+	ret = sample_conv_check(type);
+	if (ret != SUCCESS)
+		return ret;
+
+#ifdef SAMPLE_CONV_SIMD
+	if (sample_conv_vec_init(type, &p))
+		for (; i + 8 <= nb_samples; i += 8)
+			sample_conv_vec_store_float(dst + i,
+						    sample_conv_vec_load(s + 2 * i, &p),
+						    p.is_signed, scale);
+#endif
+	for (; i < nb_samples; i += n) {
+		n = nb_samples - i;
+		if (n > SAMPLE_CONV_CHUNK)
+			n = SAMPLE_CONV_CHUNK;
+		sample_conv_portable(type, s, i, chunk, n);
+		for (j = 0; j < n; j++) {
+			if (type->sign == 's')
+				dst[i + j] = chunk[j] * scale;
+			else
+				dst[i + j] = (uint32_t)chunk[j] * scale;
+		}
+	}
+
+	return SUCCESS;
+}